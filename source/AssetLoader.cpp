@@ -0,0 +1,45 @@
+#include "pch.h"
+#include "AssetLoader.h"
+#include "Texture.h"
+#include "CachedMesh.h"
+#include "ThreadPool.h"
+
+namespace dae
+{
+	AssetLoader::AssetLoader(ID3D11Device* pDevice, int numThreads)
+		:m_pDevice{ pDevice },
+		m_pThreadPool{ new ThreadPool{ numThreads } },
+		m_IsPngInitialized{ (IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) != 0 }
+	{
+		if (!m_IsPngInitialized)
+		{
+			std::cout << "SDL_image png initialization failed: " << IMG_GetError() << "\n";
+		}
+	}
+
+	AssetLoader::~AssetLoader()
+	{
+		delete m_pThreadPool;
+
+		if (m_IsPngInitialized)
+		{
+			IMG_Quit();
+		}
+	}
+
+	std::future<Texture*> AssetLoader::LoadTexture(const std::string& path)
+	{
+		//Without the decoder set up front every decode would try to set it up, so they are decoded one by one when waited on
+		if (!m_IsPngInitialized)
+		{
+			return std::async(std::launch::deferred, [path, pDevice = m_pDevice]() { return Texture::LoadFromFile(path, pDevice); });
+		}
+
+		return m_pThreadPool->Submit([path, pDevice = m_pDevice]() { return Texture::LoadFromFile(path, pDevice); });
+	}
+
+	std::future<CachedMesh*> AssetLoader::LoadMesh(const std::string& objPath)
+	{
+		return m_pThreadPool->Submit([objPath]() { return new CachedMesh{ objPath }; });
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <future>
+
+namespace dae
+{
+	class Texture;
+	class CachedMesh;
+	class ThreadPool;
+
+	//Loads textures and meshes on a thread pool, every load returns right away with a future of the asset
+	//so all of them are decoded at the same time. The caller owns the loaded assets
+	//Texture creation only uses the device, which is free threaded, never the device context
+	//SDL_image sets up its png decoder on the first decode and that isn't thread safe, so the loader does it up front
+	class AssetLoader final
+	{
+	public:
+		//numThreads includes the calling thread, which doesn't load, 0 uses every hardware thread
+		explicit AssetLoader(ID3D11Device* pDevice, int numThreads = 0);
+		//Waits for the loads that are still running
+		~AssetLoader();
+
+		AssetLoader(const AssetLoader&) = delete;
+		AssetLoader(AssetLoader&&) noexcept = delete;
+		AssetLoader& operator=(const AssetLoader&) = delete;
+		AssetLoader& operator=(AssetLoader&&) noexcept = delete;
+
+		std::future<Texture*> LoadTexture(const std::string& path);
+		std::future<CachedMesh*> LoadMesh(const std::string& objPath);
+
+	private:
+		ID3D11Device* m_pDevice{};
+		ThreadPool* m_pThreadPool{};
+		bool m_IsPngInitialized{};
+	};
+}
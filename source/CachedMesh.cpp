@@ -0,0 +1,130 @@
+#include "pch.h"
+#include "CachedMesh.h"
+#include "MappedFile.h"
+#include "Utils.h"
+#include "MeshOptimizer.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace dae
+{
+	CachedMesh::CachedMesh(const std::string& objPath, bool flipAxisAndWinding)
+	{
+		std::error_code error{};
+		const uint64_t sourceSize{ std::filesystem::file_size(objPath, error) };
+		if (error)
+			return;
+
+		const auto sourceWriteTime{ std::filesystem::last_write_time(objPath, error) };
+		if (error)
+			return;
+
+		Header header{};
+		header.magic = m_Magic;
+		header.version = m_Version;
+		header.vertexSize = sizeof(Vertex);
+		header.flipAxisAndWinding = flipAxisAndWinding;
+		header.sourceSize = sourceSize;
+		header.sourceWriteTime = static_cast<int64_t>(sourceWriteTime.time_since_epoch().count());
+
+		const std::string cachePath{ objPath + ".cache" };
+
+		if (MapCache(cachePath, header))
+		{
+			m_IsValid = true;
+			return;
+		}
+
+		if (!Utils::ParseOBJ(objPath, m_ParsedVertices, m_ParsedIndices, flipAxisAndWinding))
+			return;
+
+		MeshOptimizer::OptimizeVertexCache(m_ParsedIndices, m_ParsedVertices.size());
+		MeshOptimizer::OptimizeVertexFetch(m_ParsedVertices, m_ParsedIndices);
+
+		m_Vertices = m_ParsedVertices;
+		m_Indices = m_ParsedIndices;
+
+		if (!m_ParsedVertices.empty())
+		{
+			m_BoundsMin = m_BoundsMax = m_ParsedVertices[0].position;
+			for (const Vertex& vertex : m_ParsedVertices)
+			{
+				m_BoundsMin = { std::min(m_BoundsMin.x, vertex.position.x), std::min(m_BoundsMin.y, vertex.position.y), std::min(m_BoundsMin.z, vertex.position.z) };
+				m_BoundsMax = { std::max(m_BoundsMax.x, vertex.position.x), std::max(m_BoundsMax.y, vertex.position.y), std::max(m_BoundsMax.z, vertex.position.z) };
+			}
+		}
+
+		header.numVertices = static_cast<uint32_t>(m_ParsedVertices.size());
+		header.numIndices = static_cast<uint32_t>(m_ParsedIndices.size());
+		header.boundsMin = m_BoundsMin;
+		header.boundsMax = m_BoundsMax;
+
+		WriteCache(cachePath, header);
+
+		m_IsValid = true;
+	}
+
+	CachedMesh::~CachedMesh()
+	{
+		delete m_pCacheFile;
+	}
+
+	bool CachedMesh::MapCache(const std::string& cachePath, const Header& expectedHeader)
+	{
+		MappedFile* pFile{ new MappedFile{ cachePath } };
+
+		if (pFile->GetSize() < sizeof(Header))
+		{
+			delete pFile;
+			return false;
+		}
+
+		const Header& header{ *reinterpret_cast<const Header*>(pFile->GetData()) };
+
+		const bool isCurrent{ header.magic == expectedHeader.magic && header.version == expectedHeader.version
+			&& header.vertexSize == expectedHeader.vertexSize && header.flipAxisAndWinding == expectedHeader.flipAxisAndWinding
+			&& header.sourceSize == expectedHeader.sourceSize && header.sourceWriteTime == expectedHeader.sourceWriteTime };
+
+		//A cache that was only partially written is rejected by its size
+		const size_t expectedSize{ sizeof(Header) + header.numVertices * sizeof(Vertex) + header.numIndices * sizeof(uint32_t) };
+
+		if (!isCurrent || pFile->GetSize() != expectedSize)
+		{
+			delete pFile;
+			return false;
+		}
+
+		//The mapping is page aligned and the header keeps the arrays aligned, so they are used in place
+		static_assert(sizeof(Header) % alignof(Vertex) == 0 && sizeof(Vertex) % alignof(uint32_t) == 0);
+		const Vertex* pVertices{ reinterpret_cast<const Vertex*>(pFile->GetData() + sizeof(Header)) };
+		const uint32_t* pIndices{ reinterpret_cast<const uint32_t*>(pVertices + header.numVertices) };
+
+		m_Vertices = { pVertices, header.numVertices };
+		m_Indices = { pIndices, header.numIndices };
+		m_BoundsMin = header.boundsMin;
+		m_BoundsMax = header.boundsMax;
+
+		m_pCacheFile = pFile;
+		return true;
+	}
+
+	void CachedMesh::WriteCache(const std::string& cachePath, const Header& header) const
+	{
+		std::ofstream file{ cachePath, std::ios::binary | std::ios::trunc };
+		if (!file)
+			return;
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		file.write(reinterpret_cast<const char*>(m_ParsedVertices.data()), m_ParsedVertices.size() * sizeof(Vertex));
+		file.write(reinterpret_cast<const char*>(m_ParsedIndices.data()), m_ParsedIndices.size() * sizeof(uint32_t));
+
+		if (!file)
+		{
+			file.close();
+
+			std::error_code error{};
+			std::filesystem::remove(cachePath, error);
+		}
+	}
+}
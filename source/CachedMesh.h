@@ -0,0 +1,77 @@
+#pragma once
+#include "SoftwareMesh.h"
+
+namespace dae
+{
+	class MappedFile;
+
+	//Mesh loaded through a binary cache written next to its OBJ file (<file>.obj.cache)
+	//The first load parses the OBJ and writes the cache, later loads map the cache and hand out its arrays without parsing or copying
+	//A cache is rebuilt when the OBJ file changed or was written by a different version
+	//Parsed meshes are reordered for the post-transform vertex cache and vertex fetch before they are cached
+	class CachedMesh final
+	{
+	public:
+		explicit CachedMesh(const std::string& objPath, bool flipAxisAndWinding = true);
+		~CachedMesh();
+
+		CachedMesh(const CachedMesh&) = delete;
+		CachedMesh(CachedMesh&&) noexcept = delete;
+		CachedMesh& operator=(const CachedMesh&) = delete;
+		CachedMesh& operator=(CachedMesh&&) noexcept = delete;
+
+		bool IsValid() const { return m_IsValid; }
+		bool IsLoadedFromCache() const { return m_pCacheFile != nullptr; }
+
+		//Only valid as long as the CachedMesh lives
+		std::span<const Vertex> GetVertices() const { return m_Vertices; }
+		std::span<const uint32_t> GetIndices() const { return m_Indices; }
+
+		const Vector3& GetBoundsMin() const { return m_BoundsMin; }
+		const Vector3& GetBoundsMax() const { return m_BoundsMax; }
+
+		//Bump when the layout of the file or the output of Utils::ParseOBJ changes
+		static constexpr uint32_t m_Version{ 3 };
+
+	private:
+		struct Header
+		{
+			uint32_t magic{};
+			uint32_t version{};
+			uint32_t vertexSize{};
+			uint32_t flipAxisAndWinding{};
+
+			//Size and write time of the OBJ file the cache was made from
+			uint64_t sourceSize{};
+			int64_t sourceWriteTime{};
+
+			uint32_t numVertices{};
+			uint32_t numIndices{};
+
+			Vector3 boundsMin{};
+			Vector3 boundsMax{};
+		};
+
+		static constexpr uint32_t m_Magic{ 0x4853454D }; //"MESH"
+
+		MappedFile* m_pCacheFile{};
+
+		//Only used when the mesh had to be parsed
+		std::vector<Vertex> m_ParsedVertices{};
+		std::vector<uint32_t> m_ParsedIndices{};
+
+		std::span<const Vertex> m_Vertices{};
+		std::span<const uint32_t> m_Indices{};
+
+		Vector3 m_BoundsMin{};
+		Vector3 m_BoundsMax{};
+
+		bool m_IsValid{ false };
+
+		//function that maps the cache, returns false when it is missing or doesn't match the header
+		bool MapCache(const std::string& cachePath, const Header& expectedHeader);
+
+		//function that writes the parsed mesh to the cache, a failed write only costs the next load a parse
+		void WriteCache(const std::string& cachePath, const Header& header) const;
+	};
+}
@@ -65,10 +65,34 @@ namespace dae
 
 		ToggleFilter(FilterState::Point);
 
+		m_pRasterizerVariable = m_pEffect->GetVariableByName("gRasterizerState")->AsRasterizer();
+		if (!m_pRasterizerVariable->IsValid())
+		{
+			std::wcout << L"m_pRasterizerVariable not valid \n";
+		}
+
+		D3D11_RASTERIZER_DESC rasterizerDesc{};
+
+		rasterizerDesc.FillMode = D3D11_FILL_SOLID;
+		rasterizerDesc.FrontCounterClockwise = false;
+		rasterizerDesc.DepthClipEnable = true;
+
+		rasterizerDesc.CullMode = D3D11_CULL_BACK;
+		pDevice->CreateRasterizerState(&rasterizerDesc, &m_pCullBack);
+
+		rasterizerDesc.CullMode = D3D11_CULL_FRONT;
+		pDevice->CreateRasterizerState(&rasterizerDesc, &m_pCullFront);
+
+		rasterizerDesc.CullMode = D3D11_CULL_NONE;
+		pDevice->CreateRasterizerState(&rasterizerDesc, &m_pCullNone);
 	}
 
 	dae::Effect::~Effect()
 	{
+		if (m_pCullBack)m_pCullBack->Release();
+		if (m_pCullFront)m_pCullFront->Release();
+		if (m_pCullNone)m_pCullNone->Release();
+
 		if (m_pTechnique)m_pTechnique->Release();
 		if(m_pEffect)m_pEffect->Release();
 	}
@@ -104,6 +128,24 @@ namespace dae
 		}
 	}
 
+	void Effect::SetCullMode(CullMode cullMode)
+	{
+		switch (cullMode)
+		{
+		case CullMode::Back:
+			m_pRasterizerVariable->SetRasterizerState(0, m_pCullBack);
+			break;
+		case CullMode::Front:
+			m_pRasterizerVariable->SetRasterizerState(0, m_pCullFront);
+			break;
+		case CullMode::None:
+			m_pRasterizerVariable->SetRasterizerState(0, m_pCullNone);
+			break;
+		default:
+			break;
+		}
+	}
+
 	ID3DX11Effect* dae::Effect::LoadEffect(ID3D11Device* pDevice, const std::wstring& assetFile)
 	{
 		HRESULT result;
@@ -28,6 +28,7 @@ namespace dae
 		virtual void SetSpecularMap(Texture* pSpecularMap){};
 
 		void ToggleFilter(FilterState filter);
+		void SetCullMode(CullMode cullMode);
 
 	protected:
 		ID3DX11Effect* m_pEffect{};
@@ -39,6 +40,12 @@ namespace dae
 
 		ID3DX11EffectSamplerVariable* m_pSamplerVariable{};
 
+		ID3D11RasterizerState* m_pCullBack{};
+		ID3D11RasterizerState* m_pCullFront{};
+		ID3D11RasterizerState* m_pCullNone{};
+
+		ID3DX11EffectRasterizerVariable* m_pRasterizerVariable{};
+
 		ID3DX11EffectMatrixVariable* m_pMatWorldViewProjVariable{};
 		ID3DX11EffectMatrixVariable* m_pMatWorldVariable{};
 		ID3DX11EffectMatrixVariable* m_pMatInvViewVariable{};
@@ -0,0 +1,628 @@
+#include "pch.h"
+
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <filesystem>
+#include <SDL_image.h>
+
+#include "Camera.h"
+#include "SoftwareMesh.h"
+#include "SoftwareTexture.h"
+#include "SoftwareRasterizer.h"
+#include "Utils.h"
+#include "CachedMesh.h"
+#include "MeshOptimizer.h"
+#include "ThreadPool.h"
+
+using namespace dae;
+
+//Headless benchmark for the software rasterizer, needs no GPU and no display.
+//Usage: Headless [width] [height] [frames] [threads] [output.bmp] [point|linear|anisotropic] [forward|visibility], 0 threads uses every hardware thread
+//       Headless --load [iterations] [threads] times Utils::ParseOBJ and the binary cache on every .obj in Resources
+//       Headless --sample [millions] times SoftwareTexture::Sample on the vehicle's diffuse map in every layout and filter
+//       Headless --specular [millions] compares the accuracy and speed of the software rasterizer's specular power against powf
+//       Headless --permutations [width] [height] [frames] [threads] times every pixel pipeline permutation, with and without the visibility buffer
+
+//Counts every heap allocation so the benchmark can check that steady state frames don't allocate
+//Every replaceable form is replaced: single and array, with and without an alignment, throwing and nothrow
+static std::atomic<uint64_t> g_AllocationCount{};
+
+//Returns nullptr when out of memory, the throwing forms turn that into std::bad_alloc
+static void* CountedAllocate(std::size_t size) noexcept
+{
+	++g_AllocationCount;
+
+	return std::malloc(size > 0 ? size : 1);
+}
+
+static void* CountedAllocate(std::size_t size, std::align_val_t alignment) noexcept
+{
+	++g_AllocationCount;
+
+	const std::size_t alignmentSize{ static_cast<std::size_t>(alignment) };
+#ifdef _MSC_VER
+	return _aligned_malloc(size > 0 ? size : 1, alignmentSize);
+#else
+	//aligned_alloc wants the size to be a multiple of the alignment
+	return std::aligned_alloc(alignmentSize, (std::max<std::size_t>(size, 1) + alignmentSize - 1) / alignmentSize * alignmentSize);
+#endif
+}
+
+static void* ThrowIfNull(void* pMemory)
+{
+	if (pMemory)
+		return pMemory;
+
+	throw std::bad_alloc{};
+}
+
+static void AlignedFree(void* pMemory) noexcept
+{
+#ifdef _MSC_VER
+	_aligned_free(pMemory);
+#else
+	std::free(pMemory);
+#endif
+}
+
+void* operator new(std::size_t size) { return ThrowIfNull(CountedAllocate(size)); }
+void* operator new[](std::size_t size) { return ThrowIfNull(CountedAllocate(size)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return ThrowIfNull(CountedAllocate(size, alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return ThrowIfNull(CountedAllocate(size, alignment)); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAllocate(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAllocate(size, alignment); }
+
+void operator delete(void* pMemory) noexcept { std::free(pMemory); }
+void operator delete[](void* pMemory) noexcept { std::free(pMemory); }
+void operator delete(void* pMemory, std::size_t) noexcept { std::free(pMemory); }
+void operator delete[](void* pMemory, std::size_t) noexcept { std::free(pMemory); }
+void operator delete(void* pMemory, const std::nothrow_t&) noexcept { std::free(pMemory); }
+void operator delete[](void* pMemory, const std::nothrow_t&) noexcept { std::free(pMemory); }
+
+void operator delete(void* pMemory, std::align_val_t) noexcept { AlignedFree(pMemory); }
+void operator delete[](void* pMemory, std::align_val_t) noexcept { AlignedFree(pMemory); }
+void operator delete(void* pMemory, std::size_t, std::align_val_t) noexcept { AlignedFree(pMemory); }
+void operator delete[](void* pMemory, std::size_t, std::align_val_t) noexcept { AlignedFree(pMemory); }
+void operator delete(void* pMemory, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(pMemory); }
+void operator delete[](void* pMemory, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(pMemory); }
+
+SoftwareTexture* LoadSoftwareTexture(const std::string& path, TextureLayout layout = TextureLayout::Morton)
+{
+	SDL_Surface* pSurface{ IMG_Load(path.c_str()) };
+	if (!pSurface)
+	{
+		std::cout << "Failed to load " << path << ": " << IMG_GetError() << "\n";
+		return nullptr;
+	}
+
+	SDL_Surface* pConverted{ SDL_ConvertSurfaceFormat(pSurface, SDL_PIXELFORMAT_RGBA32, 0) };
+	const std::vector<MipLevel> mipChain{ SoftwareTexture::CreateMipChain(pConverted->w, pConverted->h, static_cast<uint32_t*>(pConverted->pixels)) };
+	SoftwareTexture* pTexture{ new SoftwareTexture{ mipChain, layout } };
+
+	SDL_FreeSurface(pConverted);
+	SDL_FreeSurface(pSurface);
+
+	return pTexture;
+}
+
+//The vehicle mesh with its material maps set
+struct VehicleAssets
+{
+	SoftwareMesh* pMesh{};
+	SoftwareTexture* pDiffuseMap{};
+	SoftwareTexture* pGlossMap{};
+	SoftwareTexture* pNormalMap{};
+	SoftwareTexture* pSpecularMap{};
+
+	~VehicleAssets()
+	{
+		delete pMesh;
+		delete pDiffuseMap;
+		delete pGlossMap;
+		delete pNormalMap;
+		delete pSpecularMap;
+	}
+};
+
+//Loads the vehicle mesh and its material maps, returns false when one of them failed to load
+bool LoadVehicle(VehicleAssets& vehicle)
+{
+	//Every asset loads on its own worker, so loading takes as long as the largest one instead of all of them in a row
+	const auto loadStart{ std::chrono::high_resolution_clock::now() };
+
+	//SDL_image sets up its png decoder on the first decode and that isn't thread safe, so it is done before the workers decode
+	if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) == 0)
+	{
+		std::cout << "SDL_image png initialization failed: " << IMG_GetError() << "\n";
+		return false;
+	}
+
+	ThreadPool loader{};
+	std::future<CachedMesh*> vehicleDataFuture{ loader.Submit([]() { return new CachedMesh{ "Resources/vehicle.obj" }; }) };
+	std::future<SoftwareTexture*> diffuseMapFuture{ loader.Submit([]() { return LoadSoftwareTexture("Resources/vehicle_diffuse.png"); }) };
+	std::future<SoftwareTexture*> glossMapFuture{ loader.Submit([]() { return LoadSoftwareTexture("Resources/vehicle_gloss.png"); }) };
+	std::future<SoftwareTexture*> normalMapFuture{ loader.Submit([]() { return LoadSoftwareTexture("Resources/vehicle_normal.png"); }) };
+	std::future<SoftwareTexture*> specularMapFuture{ loader.Submit([]() { return LoadSoftwareTexture("Resources/vehicle_specular.png"); }) };
+
+	const CachedMesh* pVehicleData{ vehicleDataFuture.get() };
+	vehicle.pDiffuseMap = diffuseMapFuture.get();
+	vehicle.pGlossMap = glossMapFuture.get();
+	vehicle.pNormalMap = normalMapFuture.get();
+	vehicle.pSpecularMap = specularMapFuture.get();
+
+	const auto loadEnd{ std::chrono::high_resolution_clock::now() };
+	std::cout << "Loaded the mesh and textures in " << std::chrono::duration<float, std::milli>(loadEnd - loadStart).count() << " ms\n";
+
+	if (!pVehicleData->IsValid())
+	{
+		std::cout << "Failed to load Resources/vehicle.obj\n";
+		delete pVehicleData;
+		return false;
+	}
+	if (!vehicle.pDiffuseMap || !vehicle.pGlossMap || !vehicle.pNormalMap || !vehicle.pSpecularMap)
+	{
+		delete pVehicleData;
+		return false;
+	}
+
+	vehicle.pMesh = new SoftwareMesh{ pVehicleData->GetVertices(), pVehicleData->GetIndices() };
+	vehicle.pMesh->SetTopology(dae::PrimitiveTopology::TriangeList);
+	delete pVehicleData;
+
+	vehicle.pMesh->SetDiffuseMap(vehicle.pDiffuseMap);
+	vehicle.pMesh->SetGlossMap(vehicle.pGlossMap);
+	vehicle.pMesh->SetNormalMap(vehicle.pNormalMap);
+	vehicle.pMesh->SetSpecularMap(vehicle.pSpecularMap);
+
+	return true;
+}
+
+//Parses every bundled mesh single threaded and with the given thread count, prints the average load time
+int RunLoadBenchmark(int iterations, int threads)
+{
+	std::vector<std::filesystem::path> paths{};
+	for (const auto& entry : std::filesystem::directory_iterator{ "Resources" })
+	{
+		if (entry.path().extension() == ".obj")
+			paths.push_back(entry.path());
+	}
+	std::sort(paths.begin(), paths.end());
+
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+
+	for (const auto& path : paths)
+	{
+		const float sizeMB{ std::filesystem::file_size(path) / (1024.f * 1024.f) };
+		std::cout << path.filename().string() << " (" << sizeMB << " MB)\n";
+
+		for (int numThreads : { 1, threads })
+		{
+			const auto start{ std::chrono::high_resolution_clock::now() };
+			for (int iteration{}; iteration < iterations; ++iteration)
+			{
+				if (!Utils::ParseOBJ(path.string(), vertices, indices, true, numThreads))
+				{
+					std::cout << "Failed to load " << path.string() << "\n";
+					return 1;
+				}
+			}
+			const auto end{ std::chrono::high_resolution_clock::now() };
+
+			const float averageMs{ std::chrono::duration<float, std::milli>(end - start).count() / std::max(iterations, 1) };
+			std::cout << "  " << (numThreads > 0 ? std::to_string(numThreads) : "all") << " threads: " << averageMs << " ms ("
+				<< sizeMB * 1000.f / std::max(averageMs, 1e-3f) << " MB/s), "
+				<< vertices.size() << " vertices, " << indices.size() / 3 << " triangles\n";
+		}
+
+		//The first load writes the cache when it is missing or out of date, only the mapped loads after it are timed
+		if (!CachedMesh{ path.string() }.IsValid())
+		{
+			std::cout << "Failed to load " << path.string() << "\n";
+			return 1;
+		}
+
+		size_t numCachedVertices{};
+		const auto start{ std::chrono::high_resolution_clock::now() };
+		for (int iteration{}; iteration < iterations; ++iteration)
+		{
+			const CachedMesh cachedMesh{ path.string() };
+			numCachedVertices = cachedMesh.GetVertices().size();
+		}
+		const auto end{ std::chrono::high_resolution_clock::now() };
+
+		std::cout << "  binary cache: " << std::chrono::duration<float, std::milli>(end - start).count() / std::max(iterations, 1) << " ms, "
+			<< numCachedVertices << " vertices\n";
+
+		//The cached indices are reordered, the parsed ones are in file order
+		const CachedMesh cachedMesh{ path.string() };
+		const MeshOptimizer::VertexCacheStats parsedStats{ MeshOptimizer::AnalyzeVertexCache(indices, vertices.size()) };
+		const MeshOptimizer::VertexCacheStats cachedStats{ MeshOptimizer::AnalyzeVertexCache(cachedMesh.GetIndices(), cachedMesh.GetVertices().size()) };
+		std::cout << "  vertex cache (" << MeshOptimizer::g_VertexCacheSize << " entries): ACMR " << parsedStats.acmr << " -> " << cachedStats.acmr
+			<< ", ATVR " << parsedStats.atvr << " -> " << cachedStats.atvr << "\n";
+	}
+
+	return 0;
+}
+
+//Samples a texture along the rows of rotated views like a spinning triangle does and at random uvs, in every texel layout
+//Prints the samples per second, a layout that keeps nearby texels together misses the cache less in the rotated views
+//Then times every filter state on the Morton layout with the derivatives of the views, as the rasterizer passes them
+int RunSampleBenchmark(int numMillions)
+{
+	//The uvs are generated up front so only the sampling is timed, the views are minified to two texels per pixel
+	constexpr int viewSize{ 1024 };
+	constexpr float texelsPerPixel{ 2.f };
+
+	struct SamplePattern
+	{
+		std::string name{};
+		std::vector<Vector2> uvs{};
+		Vector2 uvDerivativeX{};
+		Vector2 uvDerivativeY{};
+	};
+
+	uint32_t randomState{ 12345 };
+	const auto nextRandom{ [&randomState]() { randomState = randomState * 1664525u + 1013904223u; return (randomState >> 8) / 16777216.f; } };
+
+	std::vector<SamplePattern> patterns{};
+	for (float angle : { 0.f, 30.f, 90.f })
+	{
+		std::vector<Vector2> uvs(viewSize * viewSize);
+		const float cosAngle{ cosf(angle * TO_RADIANS) };
+		const float sinAngle{ sinf(angle * TO_RADIANS) };
+
+		for (int y{}; y < viewSize; ++y)
+		{
+			for (int x{}; x < viewSize; ++x)
+			{
+				//A pixel steps texelsPerPixel texels of a texture as wide as the view
+				const float u{ (x * cosAngle - y * sinAngle) * texelsPerPixel / viewSize };
+				const float v{ (x * sinAngle + y * cosAngle) * texelsPerPixel / viewSize };
+				uvs[x + y * viewSize] = { u - floorf(u), v - floorf(v) };
+			}
+		}
+
+		const float step{ texelsPerPixel / viewSize };
+		patterns.push_back(SamplePattern{ "rows at " + std::to_string(static_cast<int>(angle)) + " degrees", std::move(uvs),
+			Vector2{ cosAngle, sinAngle } * step, Vector2{ -sinAngle, cosAngle } * step });
+	}
+
+	std::vector<Vector2> randomUVs(viewSize * viewSize);
+	for (Vector2& uv : randomUVs)
+	{
+		uv = { nextRandom(), nextRandom() };
+	}
+	patterns.push_back(SamplePattern{ "random", std::move(randomUVs), patterns[0].uvDerivativeX, patterns[0].uvDerivativeY });
+
+	const int numPasses{ std::max(1, static_cast<int>(numMillions * 1000000ll / (viewSize * viewSize))) };
+	const float numSamples{ static_cast<float>(numPasses) * viewSize * viewSize };
+
+	const auto timeSampling{ [&](const std::string& name, const SoftwareTexture* pTexture, const std::vector<Vector2>& uvs, const SamplerState& sampler)
+		{
+			//Summed per pass so the float sum doesn't lose the samples
+			float checksum{};
+
+			const auto start{ std::chrono::high_resolution_clock::now() };
+			for (int pass{}; pass < numPasses; ++pass)
+			{
+				ColorRGB sum{};
+				for (const Vector2& uv : uvs)
+				{
+					sum += pTexture->Sample(uv, sampler);
+				}
+				checksum += (sum.r + sum.g + sum.b) / numPasses;
+			}
+			const auto end{ std::chrono::high_resolution_clock::now() };
+
+			const float seconds{ std::chrono::duration<float>(end - start).count() };
+			std::cout << name << ": " << numSamples / std::max(seconds, 1e-6f) / 1e6f
+				<< " Msamples/s (checksum " << checksum << ")\n";
+		} };
+
+	for (const auto& [layoutName, layout] : { std::pair{ "linear", TextureLayout::Linear }, std::pair{ "tiled", TextureLayout::Tiled }, std::pair{ "morton", TextureLayout::Morton } })
+	{
+		SoftwareTexture* pTexture{ LoadSoftwareTexture("Resources/vehicle_diffuse.png", layout) };
+		if (!pTexture)
+			return 1;
+
+		//No derivatives, every layout is compared on the full size level
+		for (const SamplePattern& pattern : patterns)
+		{
+			timeSampling(std::string{ layoutName } + ", " + pattern.name, pTexture, pattern.uvs, SamplerState{});
+		}
+
+		delete pTexture;
+	}
+
+	SoftwareTexture* pTexture{ LoadSoftwareTexture("Resources/vehicle_diffuse.png", TextureLayout::Morton) };
+	if (!pTexture)
+		return 1;
+
+	for (const auto& [filterName, filter] : { std::pair{ "point", FilterState::Point }, std::pair{ "linear", FilterState::Linear }, std::pair{ "anisotropic", FilterState::Anisotropic } })
+	{
+		for (const SamplePattern& pattern : patterns)
+		{
+			timeSampling(std::string{ filterName } + " filter, " + pattern.name, pTexture, pattern.uvs, SamplerState{ filter, pattern.uvDerivativeX, pattern.uvDerivativeY });
+		}
+	}
+
+	delete pTexture;
+
+	return 0;
+}
+
+//Compares the Simd::Pow the software rasterizer raises the Phong cosines with against powf, the result it replaced
+//Prints the largest error over a grid of cosines and gloss values, in absolute terms and in steps of an 8 bit channel,
+//and the powers per second of both on random inputs
+int RunSpecularBenchmark(int numMillions)
+{
+	//Same shininess as the software rasterizer, the exponent is gloss * shininess with gloss in [0, 1]
+	constexpr float shininess{ 25.f };
+	constexpr int gridSize{ 1024 };
+
+	alignas(32) float cosAngles[Simd::LaneCount];
+	alignas(32) float exponents[Simd::LaneCount];
+	alignas(32) float results[Simd::LaneCount];
+
+	float maxError{};
+	float maxRelativeError{};
+	float maxChannelError{};
+	for (int glossIdx{}; glossIdx <= gridSize; ++glossIdx)
+	{
+		for (int cosIdx{}; cosIdx <= gridSize; cosIdx += Simd::LaneCount)
+		{
+			for (int lane{}; lane < Simd::LaneCount; ++lane)
+			{
+				cosAngles[lane] = std::min(cosIdx + lane, gridSize) / static_cast<float>(gridSize);
+				exponents[lane] = glossIdx * shininess / gridSize;
+			}
+			Simd::Store(results, Simd::Pow(Simd::Load(cosAngles), Simd::Load(exponents)));
+
+			for (int lane{}; lane < Simd::LaneCount; ++lane)
+			{
+				const float reference{ powf(cosAngles[lane], exponents[lane]) };
+				const float error{ std::abs(results[lane] - reference) };
+
+				maxError = std::max(maxError, error);
+				//Relative to values that still show up in an 8 bit channel
+				if (reference > 1.f / 255.f)
+					maxRelativeError = std::max(maxRelativeError, error / reference);
+				maxChannelError = std::max(maxChannelError, std::abs(std::round(results[lane] * 255.f) - std::round(reference * 255.f)));
+			}
+		}
+	}
+
+	std::cout << "Simd::Pow against powf, cosine in [0, 1], exponent in [0, " << shininess << "]\n";
+	std::cout << "Max absolute error " << maxError << ", max relative error " << maxRelativeError
+		<< ", max 8 bit channel difference " << maxChannelError << "\n";
+
+	uint32_t randomState{ 12345 };
+	const auto nextRandom{ [&randomState]() { randomState = randomState * 1664525u + 1013904223u; return (randomState >> 8) / 16777216.f; } };
+
+	constexpr int numInputs{ 1 << 16 };
+	std::vector<float> inputCosAngles(numInputs);
+	std::vector<float> inputExponents(numInputs);
+	for (int inputIdx{}; inputIdx < numInputs; ++inputIdx)
+	{
+		inputCosAngles[inputIdx] = nextRandom();
+		inputExponents[inputIdx] = nextRandom() * shininess;
+	}
+
+	const int numPasses{ std::max(1, static_cast<int>(numMillions * 1000000ll / numInputs)) };
+	const float numPowers{ static_cast<float>(numPasses) * numInputs };
+
+	const auto timePow{ [&](const std::string& name, const auto& powerFunction)
+		{
+			float checksum{};
+
+			const auto start{ std::chrono::high_resolution_clock::now() };
+			for (int pass{}; pass < numPasses; ++pass)
+			{
+				float sum{};
+				for (int inputIdx{}; inputIdx < numInputs; inputIdx += Simd::LaneCount)
+				{
+					sum += powerFunction(inputIdx);
+				}
+				checksum += sum / numPasses;
+			}
+			const auto end{ std::chrono::high_resolution_clock::now() };
+
+			const float seconds{ std::chrono::duration<float>(end - start).count() };
+			std::cout << name << ": " << numPowers / std::max(seconds, 1e-6f) / 1e6f << " Mpowers/s (checksum " << checksum << ")\n";
+		} };
+
+	timePow("powf", [&](int firstInput)
+		{
+			float sum{};
+			for (int lane{}; lane < Simd::LaneCount; ++lane)
+			{
+				sum += powf(inputCosAngles[firstInput + lane], inputExponents[firstInput + lane]);
+			}
+			return sum;
+		});
+
+	timePow("Simd::Pow, " + std::to_string(Simd::LaneCount) + " lanes", [&](int firstInput)
+		{
+			Simd::Store(results, Simd::Pow(Simd::Load(&inputCosAngles[firstInput]), Simd::Load(&inputExponents[firstInput])));
+
+			float sum{};
+			for (int lane{}; lane < Simd::LaneCount; ++lane)
+			{
+				sum += results[lane];
+			}
+			return sum;
+		});
+
+	return 0;
+}
+
+//Renders the spinning vehicle with every pixel pipeline permutation, the rasterizer picks the one matching its state per draw
+//Prints the average frame time of each, the difference between them is the cost of the shading work they skip,
+//and the pixels that passed the depth test and were shaded in the last frame
+int RunPermutationBenchmark(int width, int height, int frames, int threads)
+{
+	VehicleAssets vehicle{};
+	if (!LoadVehicle(vehicle))
+		return 1;
+
+	Camera camera{};
+	camera.Initialize(45.f, { .0f,.0f, 0.f }, static_cast<float>(width) / height);
+	camera.CalculateViewMatrix();
+	camera.CalculateProjectionMatrix();
+
+	SoftwareRasterizer rasterizer{ width, height, threads };
+	std::cout << width << "x" << height << ", " << frames << " frames, " << rasterizer.GetNumThreads() << " threads\n";
+
+	struct Permutation
+	{
+		std::string name{};
+		RenderStateKey key{};
+	};
+
+	std::vector<Permutation> permutations
+	{
+		{ "bounding boxes", RenderStateKey{ .renderBoundingBox = true } },
+		{ "depth", RenderStateKey{ .renderDepth = true } }
+	};
+	for (const auto& [modeName, shadingMode] : { std::pair{ "observed area", ShadingMode::ObservedArea }, std::pair{ "diffuse", ShadingMode::Diffuse },
+		std::pair{ "specular", ShadingMode::Specular }, std::pair{ "combined", ShadingMode::Combined } })
+	{
+		permutations.push_back({ std::string{ modeName }, RenderStateKey{ shadingMode, false } });
+		permutations.push_back({ std::string{ modeName } + " + normal map", RenderStateKey{ shadingMode, true } });
+		permutations.push_back({ std::string{ modeName } + " + visibility buffer", RenderStateKey{ .shadingMode = shadingMode, .useNormalMap = false, .visibilityBuffer = true } });
+		permutations.push_back({ std::string{ modeName } + " + normal map + visibility buffer", RenderStateKey{ .shadingMode = shadingMode, .useNormalMap = true, .visibilityBuffer = true } });
+	}
+
+	for (const Permutation& permutation : permutations)
+	{
+		rasterizer.SetShadingMode(permutation.key.shadingMode);
+		rasterizer.SetUseNormalMap(permutation.key.useNormalMap);
+		rasterizer.SetRenderDepth(permutation.key.renderDepth);
+		rasterizer.SetRenderBoundingBox(permutation.key.renderBoundingBox);
+		rasterizer.SetUseVisibilityBuffer(permutation.key.visibilityBuffer);
+
+		//Every permutation renders the same frames
+		Matrix worldMatrix{ Matrix::CreateTranslation(0.f, 0.f, 50.f) };
+
+		const auto start{ std::chrono::high_resolution_clock::now() };
+		for (int frame{}; frame < frames; ++frame)
+		{
+			worldMatrix = Matrix::CreateRotationY(1.f / 60.f) * worldMatrix;
+			rasterizer.SetMatrices(worldMatrix * camera.viewMatrix * camera.projectionMatrix, worldMatrix);
+
+			rasterizer.ClearBuffers(ColorRGB{ 100, 100, 100 } / 255.f);
+			rasterizer.RenderMesh(*vehicle.pMesh);
+		}
+		const auto end{ std::chrono::high_resolution_clock::now() };
+
+		const float totalMs{ std::chrono::duration<float, std::milli>(end - start).count() };
+		const OverdrawStats overdrawStats{ rasterizer.GetOverdrawStats() };
+		std::cout << permutation.name << ": " << totalMs / std::max(frames, 1) << " ms, "
+			<< overdrawStats.pixelsShaded << "/" << overdrawStats.pixelsWritten << " pixels shaded\n";
+	}
+
+	return 0;
+}
+
+#undef main
+int main(int argc, char* args[])
+{
+	if (argc > 1 && std::string{ args[1] } == "--load")
+		return RunLoadBenchmark(argc > 2 ? std::stoi(args[2]) : 10, argc > 3 ? std::stoi(args[3]) : 0);
+
+	if (argc > 1 && std::string{ args[1] } == "--sample")
+		return RunSampleBenchmark(argc > 2 ? std::stoi(args[2]) : 100);
+
+	if (argc > 1 && std::string{ args[1] } == "--specular")
+		return RunSpecularBenchmark(argc > 2 ? std::stoi(args[2]) : 100);
+
+	if (argc > 1 && std::string{ args[1] } == "--permutations")
+		return RunPermutationBenchmark(argc > 2 ? std::stoi(args[2]) : 640, argc > 3 ? std::stoi(args[3]) : 480,
+			argc > 4 ? std::stoi(args[4]) : 100, argc > 5 ? std::stoi(args[5]) : 0);
+
+	const int width{ argc > 1 ? std::stoi(args[1]) : 640 };
+	const int height{ argc > 2 ? std::stoi(args[2]) : 480 };
+	const int frames{ argc > 3 ? std::stoi(args[3]) : 100 };
+	const int threads{ argc > 4 ? std::stoi(args[4]) : 0 };
+	const std::string outputPath{ argc > 5 ? args[5] : "" };
+	const std::string filterName{ argc > 6 ? args[6] : "point" };
+	const std::string shadingName{ argc > 7 ? args[7] : "forward" };
+
+	FilterState filterState{ FilterState::Point };
+	if (filterName == "linear")
+		filterState = FilterState::Linear;
+	else if (filterName == "anisotropic")
+		filterState = FilterState::Anisotropic;
+
+	VehicleAssets vehicle{};
+	if (!LoadVehicle(vehicle))
+		return 1;
+
+	SoftwareMesh& vehicleMesh{ *vehicle.pMesh };
+
+	//Same camera setup as the windowed renderer
+	Camera camera{};
+	camera.Initialize(45.f, { .0f,.0f, 0.f }, static_cast<float>(width) / height);
+	camera.CalculateViewMatrix();
+	camera.CalculateProjectionMatrix();
+
+	SoftwareRasterizer rasterizer{ width, height, threads };
+	rasterizer.SetFilterState(filterState);
+	rasterizer.SetUseVisibilityBuffer(shadingName == "visibility");
+
+	Matrix worldMatrix{ Matrix::CreateTranslation(0.f, 0.f, 50.f) };
+
+	//Rotate at the windowed renderer's speed, assuming a fixed 60Hz step so the result is deterministic
+	const float rotationSpeed{ 1.f };
+	const float frameStep{ 1.f / 60.f };
+
+	//Warm up frame, grows the scratch buffers of the rasterizer to their steady state size
+	rasterizer.SetMatrices(worldMatrix * camera.viewMatrix * camera.projectionMatrix, worldMatrix);
+	rasterizer.ClearBuffers(ColorRGB{ 100, 100, 100 } / 255.f);
+	rasterizer.RenderMesh(vehicleMesh);
+
+	const uint64_t startAllocationCount{ g_AllocationCount };
+	const auto start{ std::chrono::high_resolution_clock::now() };
+	for (int frame{}; frame < frames; ++frame)
+	{
+		worldMatrix = Matrix::CreateRotationY(rotationSpeed * frameStep) * worldMatrix;
+		rasterizer.SetMatrices(worldMatrix * camera.viewMatrix * camera.projectionMatrix, worldMatrix);
+
+		rasterizer.ClearBuffers(ColorRGB{ 100, 100, 100 } / 255.f);
+		rasterizer.RenderMesh(vehicleMesh);
+	}
+	const auto end{ std::chrono::high_resolution_clock::now() };
+	const uint64_t frameAllocationCount{ g_AllocationCount - startAllocationCount };
+
+	const float totalMs{ std::chrono::duration<float, std::milli>(end - start).count() };
+	std::cout << width << "x" << height << ", " << frames << " frames, " << rasterizer.GetNumThreads() << " threads, " << filterName << " filter, "
+		<< shadingName << " shading\n";
+	std::cout << "Average frame time: " << totalMs / std::max(frames, 1) << " ms ("
+		<< frames * 1000.f / std::max(totalMs, 1e-3f) << " FPS)\n";
+	std::cout << "Heap allocations: " << frameAllocationCount << " in " << frames << " frames\n";
+
+	//Counters of the last frame
+	const CullStats cullStats{ rasterizer.GetCullStats() };
+	std::cout << "Culling: " << cullStats.trianglesFacingCulled << "/" << cullStats.trianglesSubmitted << " triangles facing away\n";
+	std::cout << "Hierarchical Z: " << cullStats.trianglesCulled << "/" << cullStats.trianglesTested << " triangles, "
+		<< cullStats.blocksCulled << "/" << cullStats.blocksTested << " 8x8 blocks culled\n";
+
+	const OverdrawStats overdrawStats{ rasterizer.GetOverdrawStats() };
+	std::cout << "Overdraw: " << overdrawStats.pixelsWritten << " pixels passed the depth test, " << overdrawStats.pixelsShaded << " shaded\n";
+
+	if (!outputPath.empty())
+	{
+		SDL_Surface* pFrame{ SDL_CreateRGBSurfaceFrom(rasterizer.GetColorBuffer(), width, height, 32, rasterizer.GetStride() * 4,
+			0x00FF0000, 0x0000FF00, 0x000000FF, 0) };
+		SDL_SaveBMP(pFrame, outputPath.c_str());
+		SDL_FreeSurface(pFrame);
+	}
+
+	return 0;
+}
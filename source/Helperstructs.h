@@ -1,7 +1,6 @@
 #pragma once
 #include "Math.h"
 #include "vector"
-#include "Camera.h"
 
 namespace dae
 {
@@ -18,6 +17,9 @@ namespace dae
 	{
 		Vector4 position{};
 		Vector2 uv{};
+		//Change of the uv per pixel along the screen's x and y axis, selects the mip level of the textures
+		Vector2 uvDerivativeX{};
+		Vector2 uvDerivativeY{};
 		Vector3 normal{};
 		Vector3 tangent{};
 		Vector3 viewDirection{};
@@ -31,8 +33,8 @@ namespace dae
 		}
 		BoundingBox(int screenWidth, int screenHeight)
 		{
-			clampX = screenWidth + 1;
-			clampY = screenHeight + 1;
+			clampX = screenWidth;
+			clampY = screenHeight;
 		}
 
 		int minX{ INT_MAX };
@@ -59,26 +61,72 @@ namespace dae
 		}
 	};
 
+	//Counters of the triangle culling stage and the hierarchical depth test
+	struct CullStats
+	{
+		//Triangles submitted by the draws and the ones the cull mode rejected for facing the wrong way
+		uint32_t trianglesSubmitted{};
+		uint32_t trianglesFacingCulled{};
+
+		//Hierarchical depth test
+		uint32_t trianglesTested{};
+		uint32_t trianglesCulled{};
+
+		uint32_t blocksTested{};
+		uint32_t blocksCulled{};
+	};
+
+	//Pixel counters of the depth test and the pixel shader, every written pixel that is written again later was shaded for nothing
+	//unless the visibility buffer defers the shading until only the visible triangle is left
+	struct OverdrawStats
+	{
+		uint32_t pixelsWritten{};
+		uint32_t pixelsShaded{};
+	};
+
+	//Triangle that passed primitive assembly together with the range of tiles its bounding box overlaps
+	struct BinnedTriangle
+	{
+		uint32_t triangleIdx{};
+
+		int minTileX{};
+		int minTileY{};
+
+		int maxTileX{};
+		int maxTileY{};
+	};
+
+	//Screen region rasterized independently by one worker, the triangles overlapping it are binned in submission order
+	struct Tile
+	{
+		int minX{};
+		int minY{};
+
+		int maxX{};
+		int maxY{};
+
+		//Range of the tile in the binned triangle list of the rasterizer
+		int firstTriangle{};
+		int numTriangles{};
+
+		CullStats cullStats{};
+		OverdrawStats overdrawStats{};
+
+		//ClearBuffers only sets needsClear, the first draw into the tile or a buffer getter clears its depth and color
+		bool needsClear{};
+		//The color of the tile still holds the clear color, so clearing it again is skipped
+		bool colorIsClear{};
+	};
+
 	enum class PrimitiveTopology
 	{
 		TriangeList,
 		TriangleStrip
 	};
 
+	//Fixed-size triangle record, assembled on the stack so primitive assembly never allocates
 	struct Triangle
 	{
-		Triangle() {
-			ndc.resize(3); screen.resize(3); isOutsideFrustum.resize(3);
-		};
-
-		void CheckOutsideFrustum(const Camera& camera)
-		{
-			for (int i{}; i < ndc.size(); i++)
-			{
-				isOutsideFrustum[i] = camera.IsOutsideFrustum(ndc[i].position);
-			}
-		};
-
 		void ScreenToNdc(const Triangle& other, float width, float height)
 		{
 			for (int i{}; i < screen.size(); i++)
@@ -151,9 +199,8 @@ namespace dae
 		};
 
 
-		std::vector<bool> isOutsideFrustum;
-		std::vector<Vertex_Out> ndc;
-		std::vector<Vector2> screen;
-		BoundingBox boundingBox;
+		std::array<Vertex_Out, 3> ndc{};
+		std::array<Vector2, 3> screen{};
+		BoundingBox boundingBox{};
 	};
 }
\ No newline at end of file
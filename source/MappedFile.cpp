@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dae
+{
+#if defined(_WIN32)
+	MappedFile::MappedFile(const std::string& path)
+	{
+		m_FileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (m_FileHandle == INVALID_HANDLE_VALUE)
+		{
+			m_FileHandle = nullptr;
+			return;
+		}
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(m_FileHandle, &size))
+			return;
+
+		m_Size = static_cast<size_t>(size.QuadPart);
+		m_IsValid = true;
+
+		//Empty files can't be mapped
+		if (m_Size == 0)
+			return;
+
+		m_MappingHandle = CreateFileMappingA(m_FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_MappingHandle)
+		{
+			m_pData = static_cast<const char*>(MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0));
+		}
+
+		if (!m_pData)
+		{
+			m_Size = 0;
+			m_IsValid = false;
+		}
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_pData)
+			UnmapViewOfFile(m_pData);
+
+		if (m_MappingHandle)
+			CloseHandle(m_MappingHandle);
+
+		if (m_FileHandle)
+			CloseHandle(m_FileHandle);
+	}
+#else
+	MappedFile::MappedFile(const std::string& path)
+	{
+		const int fileDescriptor{ open(path.c_str(), O_RDONLY) };
+		if (fileDescriptor < 0)
+			return;
+
+		struct stat fileStats {};
+		if (fstat(fileDescriptor, &fileStats) == 0)
+		{
+			m_Size = static_cast<size_t>(fileStats.st_size);
+			m_IsValid = true;
+
+			//Empty files can't be mapped
+			if (m_Size > 0)
+			{
+				void* pMapping{ mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0) };
+
+				if (pMapping != MAP_FAILED)
+				{
+					madvise(pMapping, m_Size, MADV_SEQUENTIAL);
+					m_pData = static_cast<const char*>(pMapping);
+				}
+				else
+				{
+					m_Size = 0;
+					m_IsValid = false;
+				}
+			}
+		}
+
+		//The mapping stays valid after the file is closed
+		close(fileDescriptor);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_pData)
+			munmap(const_cast<char*>(m_pData), m_Size);
+	}
+#endif
+}
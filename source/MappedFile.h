@@ -0,0 +1,33 @@
+#pragma once
+
+namespace dae
+{
+	//Read only view of a whole file mapped into memory, the contents are paged in by the OS on first access
+	class MappedFile final
+	{
+	public:
+		explicit MappedFile(const std::string& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&&) noexcept = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&&) noexcept = delete;
+
+		//False when the file couldn't be opened, an empty file is valid but has no data
+		bool IsValid() const { return m_IsValid; }
+
+		const char* GetData() const { return m_pData; }
+		size_t GetSize() const { return m_Size; }
+
+	private:
+		const char* m_pData{};
+		size_t m_Size{};
+		bool m_IsValid{ false };
+
+#if defined(_WIN32)
+		void* m_FileHandle{};
+		void* m_MappingHandle{};
+#endif
+	};
+}
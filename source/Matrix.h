@@ -19,6 +19,7 @@ namespace dae {
 			const Vector4& t);
 
 		Matrix(const Matrix& m);
+		Matrix& operator=(const Matrix& m) = default;
 
 		Vector3 TransformVector(const Vector3& v) const;
 		Vector3 TransformVector(float x, float y, float z) const;
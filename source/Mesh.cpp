@@ -7,9 +7,8 @@
 
 namespace dae
 {
-	dae::Mesh::Mesh(ID3D11Device* pDevice, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, EffectType type)
-		:m_Vertices{vertices},
-		m_Indices{indices}
+	dae::Mesh::Mesh(ID3D11Device* pDevice, std::span<const Vertex> vertices, std::span<const uint32_t> indices, EffectType type)
+		:m_SoftwareMesh{ vertices, indices }
 	{
 		switch (type)
 		{
@@ -131,25 +130,34 @@ namespace dae
 	void Mesh::SetDiffuseMap(Texture* pDiffuseTexture)
 	{
 		m_pEffect->SetDiffuseMap(pDiffuseTexture);
+		m_SoftwareMesh.SetDiffuseMap(pDiffuseTexture->GetSoftwareTexture());
 	}
 
 	void Mesh::SetGlossmap(Texture* pGlossMap)
 	{
 		m_pEffect->SetGlossmap(pGlossMap);
+		m_SoftwareMesh.SetGlossMap(pGlossMap->GetSoftwareTexture());
 	}
 
 	void Mesh::SetNormalMap(Texture* pNormalMap)
 	{
 		m_pEffect->SetNormalMap(pNormalMap);
+		m_SoftwareMesh.SetNormalMap(pNormalMap->GetSoftwareTexture());
 	}
 
 	void Mesh::SetSpecularMap(Texture* pSpecularMap)
 	{
 		m_pEffect->SetSpecularMap(pSpecularMap);
+		m_SoftwareMesh.SetSpecularMap(pSpecularMap->GetSoftwareTexture());
 	}
 
 	void Mesh::ToggleFilter(FilterState filter)
 	{
 		m_pEffect->ToggleFilter(filter);
 	}
+
+	void Mesh::SetCullMode(CullMode cullMode)
+	{
+		m_pEffect->SetCullMode(cullMode);
+	}
 }
\ No newline at end of file
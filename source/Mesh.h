@@ -1,24 +1,16 @@
 #pragma once
+#include "SoftwareMesh.h"
 
 namespace dae
 {
 	class Effect;
 	class Texture;
 
-	struct Vertex
-	{
-		Vector3 position;
-		Vector3 normal;
-		Vector3 tangent;
-		Vector2 uv;
-		Vector3 viewDirection{};
-	};
-
 	class Mesh final
 	{
 	public:
 		Mesh() = delete;
-		Mesh(ID3D11Device* pDevice, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indicess, EffectType type);
+		Mesh(ID3D11Device* pDevice, std::span<const Vertex> vertices, std::span<const uint32_t> indices, EffectType type);
 
 		~Mesh();
 
@@ -36,22 +28,17 @@ namespace dae
 		void SetSpecularMap(Texture* pSpecularMap);
 
 		void ToggleFilter(FilterState filter);
+		void SetCullMode(CullMode cullMode);
 
-		std::vector<Vertex>& GetVertices() { return m_Vertices; }
-		std::vector<Vertex_Out>& GetVerticesOut() { return m_Vertices_out; }
-		std::vector<uint32_t>& GetIndices() { return m_Indices; }
-		PrimitiveTopology GetTopology() { return m_PrimitiveTopology; }
+		SoftwareMesh& GetSoftwareMesh() { return m_SoftwareMesh; }
 
-		void SetTopology(PrimitiveTopology topology) { m_PrimitiveTopology = topology; }
+		void SetTopology(PrimitiveTopology topology) { m_SoftwareMesh.SetTopology(topology); }
 
 	private:
 		Effect* m_pEffect;
 
-		std::vector<Vertex> m_Vertices{};
-		std::vector<uint32_t> m_Indices{};
-		PrimitiveTopology m_PrimitiveTopology{ PrimitiveTopology::TriangleStrip };
-
-		std::vector<Vertex_Out> m_Vertices_out{};
+		//CPU side copy of the geometry, rendered by the software rasterizer
+		SoftwareMesh m_SoftwareMesh;
 
 		ID3D11InputLayout* m_pInputLayout{};
 
@@ -0,0 +1,185 @@
+#include "pch.h"
+#include "MeshOptimizer.h"
+
+namespace dae
+{
+	namespace MeshOptimizer
+	{
+		void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices, int cacheSize)
+		{
+			const size_t numTriangles{ indices.size() / 3 };
+			if (numTriangles == 0 || numVertices == 0)
+				return;
+
+			//Triangles using every vertex, stored as one array with an offset per vertex
+			std::vector<uint32_t> liveTriangles(numVertices);
+			for (uint32_t index : indices)
+			{
+				++liveTriangles[index];
+			}
+
+			std::vector<uint32_t> adjacencyOffsets(numVertices + 1);
+			for (size_t vertexIdx{}; vertexIdx < numVertices; ++vertexIdx)
+			{
+				adjacencyOffsets[vertexIdx + 1] = adjacencyOffsets[vertexIdx] + liveTriangles[vertexIdx];
+			}
+
+			std::vector<uint32_t> adjacency(indices.size());
+			std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i{}; i < indices.size(); ++i)
+			{
+				adjacency[adjacencyFill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+
+			//Time every vertex last entered the cache, a vertex is cached while fewer than cacheSize vertices entered after it
+			std::vector<int> cacheTime(numVertices);
+			int timeStamp{ cacheSize + 1 };
+
+			std::vector<bool> isEmitted(numTriangles);
+			std::vector<uint32_t> deadEndStack{};
+			std::vector<uint32_t> candidates{};
+
+			std::vector<uint32_t> output{};
+			output.reserve(indices.size());
+
+			size_t cursor{ 1 };
+			int64_t fanningVertex{ 0 };
+
+			while (fanningVertex >= 0)
+			{
+				candidates.clear();
+
+				//Emit every remaining triangle around the fanning vertex
+				for (uint32_t adjacencyIdx{ adjacencyOffsets[fanningVertex] }; adjacencyIdx < adjacencyOffsets[fanningVertex + 1]; ++adjacencyIdx)
+				{
+					const uint32_t triangleIdx{ adjacency[adjacencyIdx] };
+					if (isEmitted[triangleIdx])
+						continue;
+
+					for (int corner{}; corner < 3; ++corner)
+					{
+						const uint32_t vertex{ indices[triangleIdx * 3 + corner] };
+
+						output.push_back(vertex);
+						deadEndStack.push_back(vertex);
+						candidates.push_back(vertex);
+						--liveTriangles[vertex];
+
+						if (timeStamp - cacheTime[vertex] > cacheSize)
+						{
+							cacheTime[vertex] = timeStamp++;
+						}
+					}
+
+					isEmitted[triangleIdx] = true;
+				}
+
+				//Continue with the candidate that stays in the cache the longest while its triangles are emitted
+				fanningVertex = -1;
+				int bestPriority{ -1 };
+				for (uint32_t vertex : candidates)
+				{
+					if (liveTriangles[vertex] == 0)
+						continue;
+
+					int priority{};
+					if (timeStamp - cacheTime[vertex] + 2 * static_cast<int>(liveTriangles[vertex]) <= cacheSize)
+					{
+						priority = timeStamp - cacheTime[vertex];
+					}
+
+					if (priority > bestPriority)
+					{
+						bestPriority = priority;
+						fanningVertex = vertex;
+					}
+				}
+
+				if (fanningVertex >= 0)
+					continue;
+
+				//Dead end, continue with a recently used vertex or else the next vertex in input order that still has triangles
+				while (!deadEndStack.empty() && fanningVertex < 0)
+				{
+					const uint32_t vertex{ deadEndStack.back() };
+					deadEndStack.pop_back();
+
+					if (liveTriangles[vertex] > 0)
+						fanningVertex = vertex;
+				}
+
+				while (cursor < numVertices && fanningVertex < 0)
+				{
+					if (liveTriangles[cursor] > 0)
+						fanningVertex = cursor;
+
+					++cursor;
+				}
+			}
+
+			indices.swap(output);
+		}
+
+		void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+		{
+			constexpr uint32_t unused{ UINT32_MAX };
+			std::vector<uint32_t> remap(vertices.size(), unused);
+
+			uint32_t nextVertex{};
+			for (uint32_t& index : indices)
+			{
+				if (remap[index] == unused)
+					remap[index] = nextVertex++;
+
+				index = remap[index];
+			}
+
+			for (uint32_t& newIndex : remap)
+			{
+				if (newIndex == unused)
+					newIndex = nextVertex++;
+			}
+
+			std::vector<Vertex> reordered(vertices.size());
+			for (size_t vertexIdx{}; vertexIdx < vertices.size(); ++vertexIdx)
+			{
+				reordered[remap[vertexIdx]] = vertices[vertexIdx];
+			}
+
+			vertices.swap(reordered);
+		}
+
+		VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, size_t numVertices, int cacheSize)
+		{
+			VertexCacheStats stats{};
+			if (indices.size() < 3 || numVertices == 0)
+				return stats;
+
+			//Miss count at which every vertex last entered the FIFO, it is still cached while fewer than cacheSize vertices entered after it
+			std::vector<int64_t> entryTime(numVertices, -static_cast<int64_t>(cacheSize) - 1);
+			std::vector<bool> isReferenced(numVertices);
+
+			int64_t numMisses{};
+			size_t numReferenced{};
+
+			for (uint32_t index : indices)
+			{
+				if (numMisses - entryTime[index] > cacheSize)
+				{
+					entryTime[index] = numMisses++;
+				}
+
+				if (!isReferenced[index])
+				{
+					isReferenced[index] = true;
+					++numReferenced;
+				}
+			}
+
+			stats.acmr = static_cast<float>(numMisses) / (indices.size() / 3);
+			stats.atvr = static_cast<float>(numMisses) / numReferenced;
+
+			return stats;
+		}
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "SoftwareMesh.h"
+
+namespace dae
+{
+	//Reorders triangle lists so transformed vertices are reused from the post-transform cache and vertices are fetched in order
+	//Both passes keep every triangle and its winding, only the order of triangles and vertices changes
+	namespace MeshOptimizer
+	{
+		//Size of the FIFO post-transform cache that is optimized for and simulated
+		constexpr int g_VertexCacheSize{ 16 };
+
+		struct VertexCacheStats
+		{
+			//Average cache miss ratio, transformed vertices per triangle (0.5 at best, 3 without reuse)
+			float acmr{};
+			//Average transform to vertex ratio, transformed vertices per referenced vertex (1 at best)
+			float atvr{};
+		};
+
+		//Tipsify (Sander et al. 2007), reorders the triangles so consecutive triangles share vertices still in the cache
+		void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices, int cacheSize = g_VertexCacheSize);
+
+		//Sorts the vertices in the order the triangles first use them and remaps the indices, unused vertices are moved to the end
+		void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+		//Simulates a FIFO post-transform cache over a triangle list
+		VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, size_t numVertices, int cacheSize = g_VertexCacheSize);
+	}
+}
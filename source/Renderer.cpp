@@ -2,7 +2,9 @@
 #include "Renderer.h"
 #include "Mesh.h"
 #include "Texture.h"
-#include "Utils.h"
+#include "SoftwareRasterizer.h"
+#include "CachedMesh.h"
+#include "AssetLoader.h"
 
 namespace dae {
 
@@ -18,12 +20,13 @@ namespace dae {
 		//Initialize Camera
 		m_Camera.Initialize(45.f, { .0f,.0f, 0.f }, m_AspectRatio);
 
-		//Create Buffers
-		m_pFrontBuffer = SDL_GetWindowSurface(pWindow);
-		m_pBackBuffer = SDL_CreateRGBSurface(0, m_Width, m_Height, 32, 0, 0, 0, 0);
-		m_pBackBufferPixels = (uint32_t*)m_pBackBuffer->pixels;
+		//Create Buffers, the back buffer wraps the color buffer of the software rasterizer (XRGB8888)
+		m_pSoftwareRasterizer = new SoftwareRasterizer{ m_Width, m_Height };
 
-		m_pDepthBufferPixels = new float[m_Width * m_Height];
+		m_pFrontBuffer = SDL_GetWindowSurface(pWindow);
+		m_pBackBuffer = SDL_CreateRGBSurfaceFrom(m_pSoftwareRasterizer->GetColorBuffer(), m_Width, m_Height, 32, m_pSoftwareRasterizer->GetStride() * 4,
+			0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+		m_CopyToFrontBuffer = m_pFrontBuffer->format->format == SDL_PIXELFORMAT_RGB888 && m_pFrontBuffer->w == m_Width && m_pFrontBuffer->h == m_Height;
 
 		//Initialize DirectX pipeline
 		const HRESULT result = InitializeDirectX();
@@ -46,17 +49,28 @@ namespace dae {
 
 	void Renderer::LoadMeshes()
 	{
-		//Create some data for our mesh
-		std::vector<Vertex> vertices{};
-		std::vector<uint32_t> indices{};
-		Utils::ParseOBJ("resources/Vehicle.obj", vertices, indices);
+		//Every asset is loaded on its own worker, startup waits for the largest one instead of all of them in a row
+		//The meshes are read from their binary cache, the mapped arrays go straight into the vertex and index buffers
+		AssetLoader loader{ m_pDevice };
+
+		std::future<CachedMesh*> vehicleData{ loader.LoadMesh("resources/Vehicle.obj") };
+		std::future<CachedMesh*> fireData{ loader.LoadMesh("resources/fireFX.obj") };
 
-		m_pVehicleMesh = new Mesh{ m_pDevice, vertices, indices, EffectType::Shaded };
+		std::future<Texture*> diffuseTextureVehicle{ loader.LoadTexture("Resources/vehicle_diffuse.png") };
+		std::future<Texture*> glossMap{ loader.LoadTexture("Resources/vehicle_gloss.png") };
+		std::future<Texture*> normalMap{ loader.LoadTexture("Resources/vehicle_normal.png") };
+		std::future<Texture*> specularMap{ loader.LoadTexture("Resources/vehicle_specular.png") };
+		std::future<Texture*> diffuseTextureFire{ loader.LoadTexture("Resources/fireFX_diffuse.png") };
 
-		m_pDiffuseTextureVehicle = Texture::LoadFromFile("Resources/vehicle_diffuse.png", m_pDevice);
-		m_pGlossMap = Texture::LoadFromFile("Resources/vehicle_gloss.png", m_pDevice);
-		m_pNormalMap = Texture::LoadFromFile("Resources/vehicle_normal.png", m_pDevice);
-		m_pSpecularMap = Texture::LoadFromFile("Resources/vehicle_specular.png", m_pDevice);
+		//The effects are compiled here while the assets load
+		const CachedMesh* pVehicleData{ vehicleData.get() };
+		m_pVehicleMesh = new Mesh{ m_pDevice, pVehicleData->GetVertices(), pVehicleData->GetIndices(), EffectType::Shaded };
+		delete pVehicleData;
+
+		m_pDiffuseTextureVehicle = diffuseTextureVehicle.get();
+		m_pGlossMap = glossMap.get();
+		m_pNormalMap = normalMap.get();
+		m_pSpecularMap = specularMap.get();
 
 		m_pVehicleMesh->SetDiffuseMap(m_pDiffuseTextureVehicle);
 		m_pVehicleMesh->SetGlossmap(m_pGlossMap);
@@ -66,10 +80,11 @@ namespace dae {
 		m_pVehicleMesh->SetTopology(dae::PrimitiveTopology::TriangeList);
 
 
-		Utils::ParseOBJ("resources/fireFX.obj", vertices, indices);
+		const CachedMesh* pFireData{ fireData.get() };
+		m_pFireMesh = new Mesh{ m_pDevice, pFireData->GetVertices(), pFireData->GetIndices(), EffectType::Transparent };
+		delete pFireData;
 
-		m_pFireMesh = new Mesh{ m_pDevice, vertices, indices, EffectType::Transparent };
-		m_pDiffuseTextureFire = Texture::LoadFromFile("Resources/fireFX_diffuse.png", m_pDevice);
+		m_pDiffuseTextureFire = diffuseTextureFire.get();
 
 		m_pFireMesh->SetDiffuseMap(m_pDiffuseTextureFire);
 	}
@@ -122,7 +137,8 @@ namespace dae {
 		delete m_pFireMesh;
 		delete m_pDiffuseTextureFire;
 
-		delete[] m_pDepthBufferPixels;
+		SDL_FreeSurface(m_pBackBuffer);
+		delete m_pSoftwareRasterizer;
 	}
 
 	void Renderer::Update(const Timer* pTimer)
@@ -133,9 +149,13 @@ namespace dae {
 		if(m_RotationEnabled)
 			m_WorldMatrix = Matrix::CreateRotationY(rotationSpeed * pTimer->GetElapsed()) * m_WorldMatrix;
 
-		m_pVehicleMesh->SetMatrices(m_WorldMatrix * m_Camera.viewMatrix * m_Camera.projectionMatrix, m_WorldMatrix, m_Camera.invViewMatrix);
+		const Matrix worldViewProjection{ m_WorldMatrix * m_Camera.viewMatrix * m_Camera.projectionMatrix };
+
+		m_pVehicleMesh->SetMatrices(worldViewProjection, m_WorldMatrix, m_Camera.invViewMatrix);
 
-		m_pFireMesh->SetMatrices(m_WorldMatrix * m_Camera.viewMatrix * m_Camera.projectionMatrix, m_WorldMatrix, m_Camera.invViewMatrix);
+		m_pFireMesh->SetMatrices(worldViewProjection, m_WorldMatrix, m_Camera.invViewMatrix);
+
+		m_pSoftwareRasterizer->SetMatrices(worldViewProjection, m_WorldMatrix);
 	}
 
 
@@ -182,323 +202,41 @@ namespace dae {
 	{
 		//@START
 		if(m_UniformClearColor)
-			SDL_FillRect(m_pBackBuffer, NULL, SDL_MapRGB(m_pBackBuffer->format, 36, 36, 36));
+			m_pSoftwareRasterizer->ClearBuffers(ColorRGB{ 36, 36, 36 } / 255.f);
 		else
-			SDL_FillRect(m_pBackBuffer, NULL, SDL_MapRGB(m_pBackBuffer->format, 100, 100, 100));
-		std::fill_n(m_pDepthBufferPixels, m_Width * m_Height, FLT_MAX);
-		//Lock BackBuffer
-		SDL_LockSurface(m_pBackBuffer);
+			m_pSoftwareRasterizer->ClearBuffers(ColorRGB{ 100, 100, 100 } / 255.f);
 
-		RenderMesh(m_pVehicleMesh);
+		m_pSoftwareRasterizer->RenderMesh(m_pVehicleMesh->GetSoftwareMesh());
 
 		//@END
-		//Update SDL Surface
-		SDL_UnlockSurface(m_pBackBuffer);
-		SDL_BlitSurface(m_pBackBuffer, 0, m_pFrontBuffer, 0);
-		SDL_UpdateWindowSurface(m_pWindow);
-	}
-
-	void dae::Renderer::RenderMesh(Mesh* mesh) const
-	{
-		VertexTransformationFunction(mesh);
-
-		std::vector<Vector2> vertices_ScreenSpace{};
-
-		auto& vertices_out{ mesh->GetVerticesOut() };
-
-		for (const auto& vertex : vertices_out)
+		//Update SDL Surface, getting the color buffer clears the tiles the draw didn't touch
+		const uint32_t* pColorBuffer{ m_pSoftwareRasterizer->GetColorBuffer() };
+		if (m_CopyToFrontBuffer)
 		{
-			vertices_ScreenSpace.push_back(
-				{
-					(vertex.position.x + 1) / 2.0f * m_Width,
-					(1.0f - vertex.position.y) / 2.0f * m_Height
-				});
-		}
+			const int stride{ m_pSoftwareRasterizer->GetStride() };
 
-		Triangle triangle{};
+			SDL_LockSurface(m_pFrontBuffer);
+			uint8_t* pFrontPixels{ static_cast<uint8_t*>(m_pFrontBuffer->pixels) };
 
-		auto& indices{ mesh->GetIndices() };
-		switch (mesh->GetTopology())
-		{
-		case PrimitiveTopology::TriangeList:
-			for (int i{}; i < indices.size(); i += 3)
+			//One copy of the whole frame when the rows line up, one per row when the surface pads them differently
+			if (m_pFrontBuffer->pitch == stride * 4)
 			{
-				if (CalculateTriangle(triangle, mesh, vertices_ScreenSpace, i))
-				{
-					RenderTriangle(triangle);
-				}
+				std::copy_n(pColorBuffer, stride * m_Height, reinterpret_cast<uint32_t*>(pFrontPixels));
 			}
-			break;
-		case PrimitiveTopology::TriangleStrip:
-			for (int i{}; i < indices.size() - 2; i++)
+			else
 			{
-				if (CalculateTriangle(triangle, mesh, vertices_ScreenSpace, i, (i % 2) == 1))
+				for (int y{}; y < m_Height; ++y)
 				{
-					RenderTriangle(triangle);
+					std::copy_n(pColorBuffer + y * stride, m_Width, reinterpret_cast<uint32_t*>(pFrontPixels + y * m_pFrontBuffer->pitch));
 				}
 			}
-			break;
-		default:
-			break;
-		}
-	}
-
-	bool dae::Renderer::CalculateTriangle(Triangle& triangle, Mesh* mesh, std::vector<Vector2>& vertices_ScreenSpace, int startIdx, bool flipTriangle) const
-	{
-		auto& indices{ mesh->GetIndices() };
-		auto& vertices_out{ mesh->GetVerticesOut() };
-
-		const uint32_t index0{ indices[startIdx] };
-		const uint32_t index1{ indices[startIdx + 1 + 1 * flipTriangle] };
-		const uint32_t index2{ indices[startIdx + 1 + 1 * !flipTriangle] };
-
-		if (index0 == index1 || index1 == index2 || index2 == index0)return false;
-
-		triangle.screen[0] = { vertices_ScreenSpace[index0] };
-		triangle.screen[1] = { vertices_ScreenSpace[index1] };
-		triangle.screen[2] = { vertices_ScreenSpace[index2] };
-
-		triangle.ndc[0] = vertices_out[index0];
-		triangle.ndc[1] = vertices_out[index1];
-		triangle.ndc[2] = vertices_out[index2];
-
-		triangle.boundingBox = GetBoundingBox(triangle.screen[0], triangle.screen[1], triangle.screen[2]);
-
-		triangle.CheckOutsideFrustum(m_Camera);
-
-		return true;
-	}
-
-	void dae::Renderer::RenderTriangle(const Triangle& triangle) const
-	{
-		if (triangle.isOutsideFrustum[0] ||
-			triangle.isOutsideFrustum[1] ||
-			triangle.isOutsideFrustum[2])
-		{
-			return;
+			SDL_UnlockSurface(m_pFrontBuffer);
 		}
-
-		const Vector2 edgeV0V1{ triangle.screen[1] - triangle.screen[0] };
-		const Vector2 edgeV1V2{ triangle.screen[2] - triangle.screen[1] };
-		const Vector2 edgeV2V0{ triangle.screen[0] - triangle.screen[2] };
-
-		const float inverseTriangleArea{ 1.f / Vector2::Cross(edgeV1V2,edgeV2V0) };
-
-		ColorRGB finalColor{};
-
-		for (int px{ triangle.boundingBox.minX }; px < triangle.boundingBox.maxX; ++px)
-		{
-			for (int py{ triangle.boundingBox.minY }; py < triangle.boundingBox.maxY; ++py)
-			{
-				const int pixelIdx{ px + py * m_Width };
-
-				if (m_RenderBoundingBox)
-				{
-					finalColor = ColorRGB{ 1, 1, 1 };
-
-					m_pBackBufferPixels[pixelIdx] = SDL_MapRGB(m_pBackBuffer->format,
-						static_cast<uint8_t>(finalColor.r * 255),
-						static_cast<uint8_t>(finalColor.g * 255),
-						static_cast<uint8_t>(finalColor.b * 255));
-
-					continue;
-				}
-
-				const Vector2 point{ static_cast<float>(px), static_cast<float>(py) };
-
-				const Vector2 v0ToPoint{ point - triangle.screen[0] };
-				const Vector2 v1ToPoint{ point - triangle.screen[1] };
-				const Vector2 v2ToPoint{ point - triangle.screen[2] };
-
-				// Calculate cross product from edge to start to point
-				const float edge01PointCross{ Vector2::Cross(edgeV0V1, v0ToPoint) };
-				const float edge12PointCross{ Vector2::Cross(edgeV1V2, v1ToPoint) };
-				const float edge20PointCross{ Vector2::Cross(edgeV2V0, v2ToPoint) };
-
-				if (!(edge01PointCross >= 0 && edge12PointCross >= 0 && edge20PointCross >= 0)) continue;
-
-				const float weightV0{ edge12PointCross * inverseTriangleArea };
-				const float weightV1{ edge20PointCross * inverseTriangleArea };
-				const float weightV2{ edge01PointCross * inverseTriangleArea };
-
-				float interpolatedZDepth
-				{
-					1.0f /
-							(weightV0 / triangle.ndc[0].position.z +
-							weightV1 / triangle.ndc[1].position.z +
-							weightV2 / triangle.ndc[2].position.z)
-				};
-
-				if (interpolatedZDepth < 0.0f || interpolatedZDepth > 1.0f ||
-					m_pDepthBufferPixels[pixelIdx] < interpolatedZDepth)
-					continue;
-
-				m_pDepthBufferPixels[pixelIdx] = interpolatedZDepth;
-
-				if (!m_RenderDepth)
-				{
-					const float interpolatedWDepth = 1.0f /
-						(weightV0 / triangle.ndc[0].position.w +
-							weightV1 / triangle.ndc[1].position.w +
-							weightV2 / triangle.ndc[2].position.w);
-
-					Pixel_Out pixelOut{ Vector4{float(px), float(py), interpolatedZDepth, interpolatedWDepth} };
-
-					pixelOut.uv = ((weightV0 * triangle.ndc[0].uv / triangle.ndc[0].position.w) +
-						(weightV1 * triangle.ndc[1].uv / triangle.ndc[1].position.w) +
-						(weightV2 * triangle.ndc[2].uv / triangle.ndc[2].position.w)) * interpolatedWDepth;
-
-					if (pixelOut.uv.x < 0 || pixelOut.uv.x > 1 ||
-						pixelOut.uv.y < 0 || pixelOut.uv.y > 1)
-						std::cout << "fuck why \n";
-
-					pixelOut.normal =
-					{
-						(((weightV0 * triangle.ndc[0].normal / triangle.ndc[0].position.w) +
-						(weightV1 * triangle.ndc[1].normal / triangle.ndc[1].position.w) +
-						(weightV2 * triangle.ndc[2].normal / triangle.ndc[2].position.w)) * interpolatedWDepth)
-					};
-					pixelOut.normal.Normalize();
-
-					pixelOut.tangent =
-					{
-						(((weightV0 * triangle.ndc[0].tangent / triangle.ndc[0].position.w) +
-						(weightV1 * triangle.ndc[1].tangent / triangle.ndc[1].position.w) +
-						(weightV2 * triangle.ndc[2].tangent / triangle.ndc[2].position.w)) * interpolatedWDepth)
-					};
-
-					pixelOut.viewDirection =
-					{
-						(((weightV0 * triangle.ndc[0].viewDirection / triangle.ndc[0].position.w) +
-						(weightV1 * triangle.ndc[1].viewDirection / triangle.ndc[1].position.w) +
-						(weightV2 * triangle.ndc[2].viewDirection / triangle.ndc[2].position.w)) * interpolatedWDepth)
-					};
-
-					finalColor = PixelShading(pixelOut);
-				}
-				else
-				{
-					const float depthColor{ Remap(interpolatedZDepth, 0.997f, 1.0f) };
-
-					finalColor = { depthColor, depthColor , depthColor };
-				}
-
-				//Update Color in Buffer
-				finalColor.MaxToOne();
-
-				m_pBackBufferPixels[px + (py * m_Width)] = SDL_MapRGB(m_pBackBuffer->format,
-					static_cast<uint8_t>(finalColor.r * 255),
-					static_cast<uint8_t>(finalColor.g * 255),
-					static_cast<uint8_t>(finalColor.b * 255));
-			}
-		}
-	}
-
-	void Renderer::VertexTransformationFunction(Mesh* mesh) const
-	{
-		auto& vertices{ mesh->GetVertices() };
-		auto& vertices_out{ mesh->GetVerticesOut() };
-
-		vertices_out.clear();
-		vertices_out.reserve(vertices.size());
-
-		Matrix worldprojectionMatrix{ m_WorldMatrix * m_Camera.viewMatrix * m_Camera.projectionMatrix };
-
-		for (auto& vertex : vertices)
-		{
-			// Tranform the vertex using the inversed view matrix
-			Vertex_Out outVertex{ worldprojectionMatrix.TransformPoint({vertex.position, 1.f}),
-				vertex.uv,
-				m_WorldMatrix.TransformVector(vertex.normal).Normalized(),
-				m_WorldMatrix.TransformVector(vertex.tangent).Normalized(),
-				worldprojectionMatrix.TransformVector(vertex.viewDirection).Normalized()
-			};
-
-			outVertex.viewDirection = Vector3{ outVertex.position.x, outVertex.position.y, outVertex.position.z };
-			outVertex.viewDirection.Normalize();
-
-			outVertex.position.x /= outVertex.position.w;
-			outVertex.position.y /= outVertex.position.w;
-			outVertex.position.z /= outVertex.position.w;
-
-			// Add the new vertex to the list of NDC vertices
-			vertices_out.emplace_back(outVertex);
-		}
-	}
-
-	ColorRGB dae::Renderer::PixelShading(Pixel_Out& pixel) const
-	{
-		Vector3 sampledNormal{ pixel.normal };
-		if (m_UseNormalMap)
-		{
-			const Vector3 binormal{ Vector3::Cross(pixel.normal, pixel.tangent) };
-			const Matrix tangentSpaceAxis{ pixel.tangent, binormal.Normalized(), pixel.normal, {0.f, 0.f, 0.f} };
-
-			const ColorRGB normalColor{ m_pNormalMap->Sample(pixel.uv) };
-			sampledNormal = { normalColor.r, normalColor.g, normalColor.b };
-
-			sampledNormal = 2 * sampledNormal - Vector3{ 1.f, 1.f, 1.f };
-			sampledNormal = tangentSpaceAxis.TransformVector(sampledNormal);
-		}
-		sampledNormal.Normalize();
-
-		const float observedArea{ std::max(0.f, Vector3::Dot(sampledNormal, -m_LightDirection)) };
-		const float kd{ .5f };
-
-		ColorRGB finalColor{};
-
-		switch (m_ShadingMode)
-		{
-		case ShadingMode::ObservedArea:
-			finalColor = ColorRGB{ 1, 1, 1 } *observedArea;
-			break;
-		case ShadingMode::Diffuse:
-		{
-			ColorRGB diffuse{ (m_pDiffuseTextureVehicle->Sample(pixel.uv) * kd) / PI * m_LightIntensity };
-			finalColor = diffuse * observedArea;
-		}
-		break;
-		case ShadingMode::Specular:
+		else
 		{
-			finalColor = CalculateSpecular(pixel, sampledNormal) * observedArea;
+			SDL_BlitSurface(m_pBackBuffer, 0, m_pFrontBuffer, 0);
 		}
-		break;
-		case ShadingMode::Combined:
-			ColorRGB diffuse{ (m_pDiffuseTextureVehicle->Sample(pixel.uv) * kd) / PI * m_LightIntensity };
-
-			finalColor = (diffuse * observedArea) + CalculateSpecular(pixel, sampledNormal);
-			break;
-		}
-
-		return finalColor;
-	}
-
-	ColorRGB dae::Renderer::CalculateSpecular(const Pixel_Out& pixel, const Vector3& sampledNormal) const
-	{
-		const Vector3 reflect{ Vector3::Reflect(m_LightDirection, sampledNormal) };
-
-		const float cosAngle{ std::max(0.f, Vector3::Dot(reflect, -pixel.viewDirection)) };
-
-		const float exp{ m_pGlossMap->Sample(pixel.uv).r * m_Shininess };
-
-		const float phongSpecular{ powf(cosAngle, exp) };
-
-		return m_pSpecularMap->Sample(pixel.uv) * phongSpecular;
-	}
-
-	BoundingBox Renderer::GetBoundingBox(Vector2 v0, Vector2 v1, Vector2 v2) const
-	{
-		BoundingBox box{ m_Width, m_Height };
-
-		box.UpdateMin(v0);
-		box.UpdateMin(v1);
-		box.UpdateMin(v2);
-
-		box.UpdateMax(v0);
-		box.UpdateMax(v1);
-		box.UpdateMax(v2);
-
-		return box;
+		SDL_UpdateWindowSurface(m_pWindow);
 	}
 
 	HRESULT Renderer::InitializeDirectX()
@@ -675,6 +413,7 @@ namespace dae {
 			return;
 
 		m_ShadingMode = static_cast<ShadingMode>((int(m_ShadingMode) + 1) % 4);
+		m_pSoftwareRasterizer->SetShadingMode(m_ShadingMode);
 
 		std::cout << "\033[35m" << "**(SOFTWARE) Shading mode = ";
 
@@ -704,6 +443,7 @@ namespace dae {
 			return;
 
 		m_UseNormalMap = !m_UseNormalMap;
+		m_pSoftwareRasterizer->SetUseNormalMap(m_UseNormalMap);
 
 		std::cout << "\033[35m" << "**(SOFTWARE) NormalMap ";
 
@@ -724,6 +464,7 @@ namespace dae {
 			return;
 
 		m_RenderDepth = !m_RenderDepth;
+		m_pSoftwareRasterizer->SetRenderDepth(m_RenderDepth);
 
 		std::cout << "\033[35m" << "**(SOFTWARE) Depth Visualization ";
 
@@ -744,6 +485,7 @@ namespace dae {
 			return;
 
 		m_RenderBoundingBox = !m_RenderBoundingBox;
+		m_pSoftwareRasterizer->SetRenderBoundingBox(m_RenderBoundingBox);
 
 		std::cout << "\033[35m" << "**(SOFTWARE) BoundingBox Visualization ";
 
@@ -758,6 +500,27 @@ namespace dae {
 		std::cout << "\033[0m";
 	}
 
+	void Renderer::ToggleVisibilityBuffer()
+	{
+		if (m_RasterizerMode != RasterizerMode::Software)
+			return;
+
+		m_UseVisibilityBuffer = !m_UseVisibilityBuffer;
+		m_pSoftwareRasterizer->SetUseVisibilityBuffer(m_UseVisibilityBuffer);
+
+		std::cout << "\033[35m" << "**(SOFTWARE) Visibility Buffer ";
+
+		if (m_UseVisibilityBuffer)
+		{
+			std::cout << "ON \n";
+		}
+		else
+		{
+			std::cout << "OFF \n";
+		}
+		std::cout << "\033[0m";
+	}
+
 	void Renderer::ToggleClearColor()
 	{
 		m_UniformClearColor = !m_UniformClearColor;
@@ -777,14 +540,11 @@ namespace dae {
 
 	void Renderer::ToggleFilterState()
 	{
-		if (m_RasterizerMode != RasterizerMode::Hardware)
-			return;
-
 		m_CurrentFilterState = static_cast<FilterState>((int(m_CurrentFilterState) + 1) % 3);
 
-		std::cout << "\033[32m";
+		std::cout << "\033[33m";
 
-		std::cout << "**(HARDWARE) Sampler Filter = ";
+		std::cout << "**(SHARED) Sampler Filter = ";
 
 		switch (m_CurrentFilterState)
 		{
@@ -805,7 +565,36 @@ namespace dae {
 
 		m_pVehicleMesh->ToggleFilter(m_CurrentFilterState);
 		m_pFireMesh->ToggleFilter(m_CurrentFilterState);
+		m_pSoftwareRasterizer->SetFilterState(m_CurrentFilterState);
+
+	}
+
+	void Renderer::CycleCullMode()
+	{
+		m_CullMode = static_cast<CullMode>((int(m_CullMode) + 1) % 3);
+
+		std::cout << "\033[33m" << "**(SHARED) CullMode = ";
+
+		switch (m_CullMode)
+		{
+		case CullMode::Back:
+			std::cout << "BACK\n";
+			break;
+		case CullMode::Front:
+			std::cout << "FRONT\n";
+			break;
+		case CullMode::None:
+			std::cout << "NONE\n";
+			break;
+		default:
+			break;
+		}
+
+		std::cout << "\033[0m";
 
+		//The fire stays double sided, it is a transparent billboard
+		m_pVehicleMesh->SetCullMode(m_CullMode);
+		m_pSoftwareRasterizer->SetCullMode(m_CullMode);
 	}
 
 
@@ -816,18 +605,19 @@ namespace dae {
 		std::cout << "\033[33m" << "[Key Bindings - SHARED] \n";
 		std::cout << "   [F1]  Toggle Rasterizer Mode (HARDWARE/SOFTWARE)\n";
 		std::cout << "   [F2]  Toggle Vehicle Rotation (ON/OFF)\n";
+		std::cout << "   [F4]  Cycle Sampler State (POINT/LINEAR/ANISOTROPIC)\n";
 		std::cout << "   [F9]  Cycle CullMode (BACK/FRONT/NONE)\n";
 		std::cout << "   [F10]  Toggle Uniform ClearColor (ON/OFF)\n";
 		std::cout << "   [F11]  Toggle Print FPS (ON/OFF)\n \n" << "\033[0m";
 		
 		std::cout << "\033[32m" << "[Key Bindings - HARDWARE] \n";
-		std::cout << "   [F3]  Toggle FireFX (ON/OFF)\n";
-		std::cout << "   [F4]  Cycle Sampler State (ON/OFF)\n \n" << "\033[0m";
+		std::cout << "   [F3]  Toggle FireFX (ON/OFF)\n \n" << "\033[0m";
 
 		std::cout << "\033[35m" << "[Key Bindings - SHARED] \n";
 		std::cout << "   [F5]  Cycle Shading Mode (COMBINED/OBSERVED_AREA/DIFFUSE/SPECULAR)\n";
 		std::cout << "   [F6]  Toggle NormalMap (ON/OFF)\n";
 		std::cout << "   [F7]  Toggle DepthBuffer Visualization (ON/OFF)\n";
-		std::cout << "   [F8]  Toggle BoundingBox Visualization (ON/OFF)\n \n" << "\033[0m";
+		std::cout << "   [F8]  Toggle BoundingBox Visualization (ON/OFF)\n";
+		std::cout << "   [F12]  Toggle Visibility Buffer (ON/OFF)\n \n" << "\033[0m";
 	}
 }
@@ -8,6 +8,7 @@ namespace dae
 {
 	class Mesh;
 	class Texture;
+	class SoftwareRasterizer;
 
 	class Renderer final
 	{
@@ -37,33 +38,36 @@ namespace dae
 
 		void ToggleBoundingBox();
 
+		void ToggleVisibilityBuffer();
+
 		void ToggleClearColor();
 
 		void ToggleFilterState();
 
+		void CycleCullMode();
+
 	private:
 		SDL_Window* m_pWindow{};
 
 		RasterizerMode m_RasterizerMode;
-		FilterState m_CurrentFilterState;
+		FilterState m_CurrentFilterState{ FilterState::Point };
 
 		bool m_RenderFire{ true };;
 		bool m_RenderBoundingBox{ false };
 		bool m_RenderDepth{ false };
 		bool m_RotationEnabled{ true };
 		bool m_UseNormalMap{ true };
+		bool m_UseVisibilityBuffer{ false };
 		bool m_UniformClearColor{ false };
 		ShadingMode m_ShadingMode{ ShadingMode::Combined };
+		CullMode m_CullMode{ CullMode::Back };
 
-		const Vector3 m_LightDirection = Vector3{ .577f, -.577f, .577f }.Normalized();
-		float m_LightIntensity{ 7.f };
-		float m_Shininess{ 25.f };
-		ColorRGB m_Ambient{ .025f, .025f, .025f };
+		SoftwareRasterizer* m_pSoftwareRasterizer{};
 
 		SDL_Surface* m_pFrontBuffer{ nullptr };
 		SDL_Surface* m_pBackBuffer{ nullptr };
-		uint32_t* m_pBackBufferPixels{};
-		float* m_pDepthBufferPixels{};
+		//The window surface stores XRGB8888 like the color buffer, presenting is a plain copy instead of a blit
+		bool m_CopyToFrontBuffer{ false };
 
 		int m_Width{};
 		int m_Height{};
@@ -106,27 +110,6 @@ namespace dae
 
 		void RenderSoftware() const;
 
-		//function that returns the bounding box for a triangle
-		BoundingBox GetBoundingBox(Vector2 v0, Vector2 v1, Vector2 v2) const;
-
-		//function that renders a single mesh
-		void RenderMesh(Mesh* mesh) const;
-
-		//function that renders a single triangle
-		void RenderTriangle(const Triangle& triangle) const;
-
-		//function to setup current triangle
-		bool CalculateTriangle(Triangle& triangle, Mesh* mesh, std::vector<Vector2>& vertices_ScreenSpace, int startIdx, bool flipTriangle = false) const;
-
-		//Function that transforms the vertices from the mesh from World space to Screen space
-		void VertexTransformationFunction(Mesh* mesh) const; //W1 Version
-
-		//Function that shades a single pixel
-		ColorRGB PixelShading(Pixel_Out& pixel) const;
-
-		ColorRGB CalculateSpecular(const Pixel_Out& pixel, const Vector3& sampeledNormal) const;
-
-
 
 
 		void PrintControls() const;
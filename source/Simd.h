@@ -0,0 +1,311 @@
+#pragma once
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace dae
+{
+	//Thin wrapper over the widest float vector the library is compiled for:
+	//AVX2 (8 lanes), SSE2 (4 lanes) or a plain array fallback (4 lanes) on other platforms
+	//Comparisons return a lane mask that can be combined with And and used by Select and MoveMask
+	//SoftwareRasterizer.h uses these types, so every project including it has to be built with the same instruction set
+	namespace Simd
+	{
+#if defined(__AVX2__)
+		constexpr int LaneCount{ 8 };
+
+		using Float = __m256;
+
+		inline Float Set(float value) { return _mm256_set1_ps(value); }
+		inline Float LaneOffsets() { return _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f); }
+		inline Float Load(const float* pData) { return _mm256_loadu_ps(pData); }
+		inline void Store(float* pData, Float value) { _mm256_storeu_ps(pData, value); }
+
+		inline Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+		inline Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+		inline Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+		inline Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+		inline Float Sqrt(Float a) { return _mm256_sqrt_ps(a); }
+		inline Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+		inline Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+		inline Float Floor(Float a) { return _mm256_floor_ps(a); }
+
+		//Unbiased exponent of a positive float, as a float
+		inline Float Exponent(Float a)
+		{
+			return _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(a), 23), _mm256_set1_epi32(127)));
+		}
+		//Mantissa of a positive float, in the [1, 2) range
+		inline Float Mantissa(Float a)
+		{
+			return _mm256_or_ps(_mm256_and_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(0x007FFFFF))), _mm256_set1_ps(1.f));
+		}
+		//2^a for a whole number a in the [-126, 127] range, built directly in the exponent bits
+		inline Float Exp2Whole(Float a)
+		{
+			return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(a), _mm256_set1_epi32(127)), 23));
+		}
+
+		inline Float GreaterEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+		inline Float LessEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+		inline Float Less(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		inline Float And(Float a, Float b) { return _mm256_and_ps(a, b); }
+
+		//mask ? a : b per lane
+		inline Float Select(Float mask, Float a, Float b) { return _mm256_blendv_ps(b, a, mask); }
+		inline int MoveMask(Float mask) { return _mm256_movemask_ps(mask); }
+
+		//Converts [0, 1] channels to 8 bits, truncating like a cast, and stores LaneCount XRGB8888 words (0x00RRGGBB)
+		inline void StoreXRGB(uint32_t* pData, Float r, Float g, Float b)
+		{
+			const __m256 scale{ _mm256_set1_ps(255.f) };
+			const __m256 zero{ _mm256_setzero_ps() };
+			const __m256i red{ _mm256_cvttps_epi32(_mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(r, scale), scale), zero)) };
+			const __m256i green{ _mm256_cvttps_epi32(_mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(g, scale), scale), zero)) };
+			const __m256i blue{ _mm256_cvttps_epi32(_mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(b, scale), scale), zero)) };
+
+			const __m256i packed{ _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(red, 16), _mm256_slli_epi32(green, 8)), blue) };
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(pData), packed);
+		}
+#elif defined(__SSE2__) || defined(_M_X64)
+		constexpr int LaneCount{ 4 };
+
+		using Float = __m128;
+
+		inline Float Set(float value) { return _mm_set1_ps(value); }
+		inline Float LaneOffsets() { return _mm_setr_ps(0.f, 1.f, 2.f, 3.f); }
+		inline Float Load(const float* pData) { return _mm_loadu_ps(pData); }
+		inline void Store(float* pData, Float value) { _mm_storeu_ps(pData, value); }
+
+		inline Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+		inline Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+		inline Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+		inline Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+		inline Float Sqrt(Float a) { return _mm_sqrt_ps(a); }
+		inline Float Min(Float a, Float b) { return _mm_min_ps(a, b); }
+		inline Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+		//SSE2 has no rounding instruction, truncate and step down the negative values that weren't whole
+		inline Float Floor(Float a)
+		{
+			const __m128 truncated{ _mm_cvtepi32_ps(_mm_cvttps_epi32(a)) };
+			return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a), _mm_set1_ps(1.f)));
+		}
+
+		//Unbiased exponent of a positive float, as a float
+		inline Float Exponent(Float a)
+		{
+			return _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(a), 23), _mm_set1_epi32(127)));
+		}
+		//Mantissa of a positive float, in the [1, 2) range
+		inline Float Mantissa(Float a)
+		{
+			return _mm_or_ps(_mm_and_ps(a, _mm_castsi128_ps(_mm_set1_epi32(0x007FFFFF))), _mm_set1_ps(1.f));
+		}
+		//2^a for a whole number a in the [-126, 127] range, built directly in the exponent bits
+		inline Float Exp2Whole(Float a)
+		{
+			return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(a), _mm_set1_epi32(127)), 23));
+		}
+
+		inline Float GreaterEqual(Float a, Float b) { return _mm_cmpge_ps(a, b); }
+		inline Float LessEqual(Float a, Float b) { return _mm_cmple_ps(a, b); }
+		inline Float Less(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+		inline Float And(Float a, Float b) { return _mm_and_ps(a, b); }
+
+		//mask ? a : b per lane
+		inline Float Select(Float mask, Float a, Float b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+		inline int MoveMask(Float mask) { return _mm_movemask_ps(mask); }
+
+		//Converts [0, 1] channels to 8 bits, truncating like a cast, and stores LaneCount XRGB8888 words (0x00RRGGBB)
+		inline void StoreXRGB(uint32_t* pData, Float r, Float g, Float b)
+		{
+			const __m128 scale{ _mm_set1_ps(255.f) };
+			const __m128 zero{ _mm_setzero_ps() };
+			const __m128i red{ _mm_cvttps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(r, scale), scale), zero)) };
+			const __m128i green{ _mm_cvttps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(g, scale), scale), zero)) };
+			const __m128i blue{ _mm_cvttps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(b, scale), scale), zero)) };
+
+			const __m128i packed{ _mm_or_si128(_mm_or_si128(_mm_slli_epi32(red, 16), _mm_slli_epi32(green, 8)), blue) };
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pData), packed);
+		}
+#else
+		constexpr int LaneCount{ 4 };
+
+		struct Float
+		{
+			float lanes[LaneCount];
+		};
+
+		template<typename Operation>
+		inline Float PerLane(Float a, Float b, Operation operation)
+		{
+			Float result;
+			for (int i{}; i < LaneCount; ++i)
+			{
+				result.lanes[i] = operation(a.lanes[i], b.lanes[i]);
+			}
+			return result;
+		}
+
+		//Masks store all ones or zero in a lane, like the intrinsics do
+		inline float MaskLane(bool value) { return value ? -1.f : 0.f; }
+
+		inline Float Set(float value) { return Float{ value, value, value, value }; }
+		inline Float LaneOffsets() { return Float{ 0.f, 1.f, 2.f, 3.f }; }
+		inline Float Load(const float* pData) { return Float{ pData[0], pData[1], pData[2], pData[3] }; }
+		inline void Store(float* pData, Float value) { std::copy(value.lanes, value.lanes + LaneCount, pData); }
+
+		inline Float Add(Float a, Float b) { return PerLane(a, b, [](float x, float y) { return x + y; }); }
+		inline Float Sub(Float a, Float b) { return PerLane(a, b, [](float x, float y) { return x - y; }); }
+		inline Float Mul(Float a, Float b) { return PerLane(a, b, [](float x, float y) { return x * y; }); }
+		inline Float Div(Float a, Float b) { return PerLane(a, b, [](float x, float y) { return x / y; }); }
+		inline Float Sqrt(Float a) { return PerLane(a, a, [](float x, float) { return std::sqrt(x); }); }
+		inline Float Min(Float a, Float b) { return PerLane(a, b, [](float x, float y) { return x < y ? x : y; }); }
+		inline Float Max(Float a, Float b) { return PerLane(a, b, [](float x, float y) { return x > y ? x : y; }); }
+		inline Float Floor(Float a) { return PerLane(a, a, [](float x, float) { return std::floor(x); }); }
+
+		//Unbiased exponent of a positive float, as a float
+		inline Float Exponent(Float a)
+		{
+			return PerLane(a, a, [](float x, float) { return static_cast<float>(static_cast<int>(std::bit_cast<uint32_t>(x) >> 23) - 127); });
+		}
+		//Mantissa of a positive float, in the [1, 2) range
+		inline Float Mantissa(Float a)
+		{
+			return PerLane(a, a, [](float x, float) { return std::bit_cast<float>((std::bit_cast<uint32_t>(x) & 0x007FFFFFu) | 0x3F800000u); });
+		}
+		//2^a for a whole number a in the [-126, 127] range, built directly in the exponent bits
+		inline Float Exp2Whole(Float a)
+		{
+			return PerLane(a, a, [](float x, float) { return std::bit_cast<float>(static_cast<uint32_t>(static_cast<int>(x) + 127) << 23); });
+		}
+
+		inline Float GreaterEqual(Float a, Float b) { return PerLane(a, b, [](float x, float y) { return MaskLane(x >= y); }); }
+		inline Float LessEqual(Float a, Float b) { return PerLane(a, b, [](float x, float y) { return MaskLane(x <= y); }); }
+		inline Float Less(Float a, Float b) { return PerLane(a, b, [](float x, float y) { return MaskLane(x < y); }); }
+		inline Float And(Float a, Float b) { return PerLane(a, b, [](float x, float y) { return MaskLane(x != 0.f && y != 0.f); }); }
+
+		//mask ? a : b per lane
+		inline Float Select(Float mask, Float a, Float b)
+		{
+			Float result;
+			for (int i{}; i < LaneCount; ++i)
+			{
+				result.lanes[i] = mask.lanes[i] != 0.f ? a.lanes[i] : b.lanes[i];
+			}
+			return result;
+		}
+
+		inline int MoveMask(Float mask)
+		{
+			int bits{};
+			for (int i{}; i < LaneCount; ++i)
+			{
+				bits |= (mask.lanes[i] != 0.f) << i;
+			}
+			return bits;
+		}
+
+		//Converts [0, 1] channels to 8 bits, truncating like a cast, and stores LaneCount XRGB8888 words (0x00RRGGBB)
+		inline void StoreXRGB(uint32_t* pData, Float r, Float g, Float b)
+		{
+			const auto toByte{ [](float channel) { return static_cast<uint32_t>(std::clamp(channel * 255.f, 0.f, 255.f)); } };
+			for (int i{}; i < LaneCount; ++i)
+			{
+				pData[i] = toByte(r.lanes[i]) << 16 | toByte(g.lanes[i]) << 8 | toByte(b.lanes[i]);
+			}
+		}
+#endif
+
+		//Multiply-add a * b + c
+		inline Float MulAdd(Float a, Float b, Float c) { return Add(Mul(a, b), c); }
+
+		//log2 of a positive value, a polynomial of the mantissa with an absolute error below 1e-5
+		//Zero returns -127 instead of minus infinity
+		inline Float Log2(Float a)
+		{
+			const Float t{ Sub(Mantissa(a), Set(1.f)) };
+
+			//log2(1 + t) / t on [0, 1), a Chebyshev fit so log2(1) is exactly zero
+			Float polynomial{ Set(-0.033822046f) };
+			polynomial = MulAdd(polynomial, t, Set(0.144471096f));
+			polynomial = MulAdd(polynomial, t, Set(-0.30163801f));
+			polynomial = MulAdd(polynomial, t, Set(0.468658879f));
+			polynomial = MulAdd(polynomial, t, Set(-0.720358773f));
+			polynomial = MulAdd(polynomial, t, Set(1.44268147f));
+
+			return MulAdd(polynomial, t, Exponent(a));
+		}
+
+		//2^a, the fraction is a polynomial with a relative error below 1e-6
+		//Results below 2^-126 flush to 2^-126 instead of going denormal
+		inline Float Exp2(Float a)
+		{
+			a = Min(Max(a, Set(-126.f)), Set(127.f));
+			const Float whole{ Floor(a) };
+			const Float fraction{ Sub(a, whole) };
+
+			//(2^f - 1) / f on [0, 1)
+			Float polynomial{ Set(0.00178836874f) };
+			polynomial = MulAdd(polynomial, fraction, Set(0.0091993876f));
+			polynomial = MulAdd(polynomial, fraction, Set(0.0556570544f));
+			polynomial = MulAdd(polynomial, fraction, Set(0.240207194f));
+			polynomial = MulAdd(polynomial, fraction, Set(0.693147568f));
+
+			return Mul(MulAdd(polynomial, fraction, Set(1.f)), Exp2Whole(whole));
+		}
+
+		//base^exponent for a base in [0, 1] and a small non negative exponent, as Phong specular needs
+		//The relative error grows with the exponent as exponent * 7e-6. A base of zero follows powf, zero or one for a zero exponent
+		inline Float Pow(Float base, Float exponent)
+		{
+			const Float zero{ Set(0.f) };
+			const Float zeroBase{ Select(LessEqual(exponent, zero), Set(1.f), zero) };
+
+			return Select(LessEqual(base, zero), zeroBase, Exp2(Mul(exponent, Log2(base))));
+		}
+
+		//The four channels of an RGBA8 texel as floats in the [0, 255] range, so a filter weights a whole texel at once
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+		using Texel = __m128;
+
+		inline Texel TexelZero() { return _mm_setzero_ps(); }
+		inline void StoreTexel(float* pData, Texel value) { _mm_storeu_ps(pData, value); }
+
+		inline Texel UnpackTexel(uint32_t texel)
+		{
+			const __m128i zero{ _mm_setzero_si128() };
+			const __m128i bytes{ _mm_cvtsi32_si128(static_cast<int>(texel)) };
+			return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+		}
+
+		//Multiply-add texel * weight + sum
+		inline Texel TexelMulAdd(Texel texel, float weight, Texel sum) { return _mm_add_ps(_mm_mul_ps(texel, _mm_set1_ps(weight)), sum); }
+#else
+		struct Texel
+		{
+			float channels[4];
+		};
+
+		inline Texel TexelZero() { return Texel{}; }
+		inline void StoreTexel(float* pData, Texel value) { std::copy(value.channels, value.channels + 4, pData); }
+
+		inline Texel UnpackTexel(uint32_t texel)
+		{
+			return Texel{ float(texel & 0xFF), float((texel >> 8) & 0xFF), float((texel >> 16) & 0xFF), float(texel >> 24) };
+		}
+
+		inline Texel TexelMulAdd(Texel texel, float weight, Texel sum)
+		{
+			for (int i{}; i < 4; ++i)
+			{
+				sum.channels[i] += texel.channels[i] * weight;
+			}
+			return sum;
+		}
+#endif
+	}
+}
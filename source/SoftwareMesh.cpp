@@ -0,0 +1,121 @@
+#include "pch.h"
+#include "SoftwareMesh.h"
+#include "SoftwareTexture.h"
+
+namespace dae
+{
+	SoftwareMesh::SoftwareMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices)
+		:m_VertexCount{ static_cast<int>(vertices.size()) },
+		m_Indices(indices.begin(), indices.end())
+	{
+		const int paddedCount{ (m_VertexCount + m_StreamAlignment - 1) / m_StreamAlignment * m_StreamAlignment };
+
+		for (std::vector<float>* pStream : { &m_VertexStreams.positionX, &m_VertexStreams.positionY, &m_VertexStreams.positionZ,
+			&m_VertexStreams.normalX, &m_VertexStreams.normalY, &m_VertexStreams.normalZ,
+			&m_VertexStreams.tangentX, &m_VertexStreams.tangentY, &m_VertexStreams.tangentZ,
+			&m_VertexStreams.u, &m_VertexStreams.v })
+		{
+			pStream->resize(paddedCount);
+		}
+
+		for (int vertexIdx{}; vertexIdx < m_VertexCount; ++vertexIdx)
+		{
+			const Vertex& vertex{ vertices[vertexIdx] };
+
+			m_VertexStreams.positionX[vertexIdx] = vertex.position.x;
+			m_VertexStreams.positionY[vertexIdx] = vertex.position.y;
+			m_VertexStreams.positionZ[vertexIdx] = vertex.position.z;
+
+			m_VertexStreams.normalX[vertexIdx] = vertex.normal.x;
+			m_VertexStreams.normalY[vertexIdx] = vertex.normal.y;
+			m_VertexStreams.normalZ[vertexIdx] = vertex.normal.z;
+
+			m_VertexStreams.tangentX[vertexIdx] = vertex.tangent.x;
+			m_VertexStreams.tangentY[vertexIdx] = vertex.tangent.y;
+			m_VertexStreams.tangentZ[vertexIdx] = vertex.tangent.z;
+
+			m_VertexStreams.u[vertexIdx] = vertex.uv.x;
+			m_VertexStreams.v[vertexIdx] = vertex.uv.y;
+		}
+
+		m_Vertices_out.resize(m_VertexCount);
+	}
+
+	SoftwareMesh::~SoftwareMesh()
+	{
+		delete m_pDiffuseGlossMap;
+		delete m_pNormalSpecularMap;
+	}
+
+	void SoftwareMesh::SetDiffuseMap(const SoftwareTexture* pDiffuseMap)
+	{
+		m_pDiffuseMap = pDiffuseMap;
+		PackDiffuseGlossMap();
+	}
+
+	void SoftwareMesh::SetGlossMap(const SoftwareTexture* pGlossMap)
+	{
+		m_pGlossMap = pGlossMap;
+		PackDiffuseGlossMap();
+	}
+
+	void SoftwareMesh::SetNormalMap(const SoftwareTexture* pNormalMap)
+	{
+		m_pNormalMap = pNormalMap;
+		PackNormalSpecularMap();
+	}
+
+	void SoftwareMesh::SetSpecularMap(const SoftwareTexture* pSpecularMap)
+	{
+		m_pSpecularMap = pSpecularMap;
+		PackNormalSpecularMap();
+	}
+
+	void SoftwareMesh::PackDiffuseGlossMap()
+	{
+		//Only the red channel of the gloss map is used, it fits in the unused alpha of the diffuse map
+		delete m_pDiffuseGlossMap;
+		m_pDiffuseGlossMap = SoftwareTexture::PackWithAlpha(m_pDiffuseMap, m_pGlossMap);
+	}
+
+	void SoftwareMesh::PackNormalSpecularMap()
+	{
+		delete m_pNormalSpecularMap;
+		m_pNormalSpecularMap = SoftwareTexture::Interleave(m_pNormalMap, m_pSpecularMap);
+	}
+
+	MaterialSample SoftwareMesh::SampleMaterial(const Vector2& uv, const SamplerState& sampler) const
+	{
+		MaterialSample sample{};
+
+		if (m_pDiffuseGlossMap)
+		{
+			sample.diffuse = m_pDiffuseGlossMap->Sample(uv, sampler, sample.gloss);
+		}
+		else
+		{
+			sample.diffuse = m_pDiffuseMap->Sample(uv, sampler);
+			sample.gloss = m_pGlossMap->Sample(uv, sampler).r;
+		}
+
+		if (m_pNormalSpecularMap)
+		{
+			m_pNormalSpecularMap->Sample(uv, sampler, sample.normal, sample.specular);
+		}
+		else
+		{
+			sample.normal = m_pNormalMap->Sample(uv, sampler);
+			sample.specular = m_pSpecularMap->Sample(uv, sampler);
+		}
+
+		return sample;
+	}
+
+	void SoftwareMesh::SetTopology(PrimitiveTopology topology)
+	{
+		m_PrimitiveTopology = topology;
+
+		//The triangles changed, only the culling has to be redone
+		m_TransformCache.cullKey = 0;
+	}
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+namespace dae
+{
+	class SoftwareTexture;
+	struct SamplerState;
+
+	struct Vertex
+	{
+		Vector3 position;
+		Vector3 normal;
+		Vector3 tangent;
+		Vector2 uv;
+		Vector3 viewDirection{};
+	};
+
+	//Vertex attributes with one array per component so they can be transformed several vertices at a time,
+	//the arrays are padded with zeroes to a multiple of m_StreamAlignment
+	struct VertexStreams
+	{
+		std::vector<float> positionX{};
+		std::vector<float> positionY{};
+		std::vector<float> positionZ{};
+
+		std::vector<float> normalX{};
+		std::vector<float> normalY{};
+		std::vector<float> normalZ{};
+
+		std::vector<float> tangentX{};
+		std::vector<float> tangentY{};
+		std::vector<float> tangentZ{};
+
+		std::vector<float> u{};
+		std::vector<float> v{};
+	};
+
+	//Every material map sampled at one uv
+	struct MaterialSample
+	{
+		ColorRGB diffuse{};
+		float gloss{};
+		ColorRGB normal{};
+		ColorRGB specular{};
+	};
+
+	//Results of the last transformation and culling of a mesh, the rasterizer reuses them while the key they were made with
+	//doesn't change so a static mesh is only rasterized. A key of 0 is never valid
+	struct TransformCache
+	{
+		uint64_t transformKey{};
+		uint64_t cullKey{};
+
+		std::vector<Vector4> vertices_Projected{};
+		std::vector<Vector2> vertices_ScreenSpace{};
+		std::vector<uint16_t> clipCodes{};
+		std::vector<uint8_t> triangleFlags{};
+	};
+
+	//CPU side mesh data used by the software rasterizer, has no dependency on DirectX or SDL
+	class SoftwareMesh final
+	{
+	public:
+		SoftwareMesh() = delete;
+		SoftwareMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices);
+
+		~SoftwareMesh();
+
+		SoftwareMesh& operator=(SoftwareMesh& rhs) = delete;
+		SoftwareMesh& operator=(SoftwareMesh&& rhs) = delete;
+		SoftwareMesh(SoftwareMesh& rhs) = delete;
+		SoftwareMesh(SoftwareMesh&& rhs) = delete;
+
+		const VertexStreams& GetVertexStreams() const { return m_VertexStreams; }
+		int GetVertexCount() const { return m_VertexCount; }
+		std::vector<Vertex_Out>& GetVerticesOut() { return m_Vertices_out; }
+		std::vector<uint32_t>& GetIndices() { return m_Indices; }
+		PrimitiveTopology GetTopology() const { return m_PrimitiveTopology; }
+		TransformCache& GetTransformCache() { return m_TransformCache; }
+
+		void SetTopology(PrimitiveTopology topology);
+
+		//Once both maps of a pair are set they are also packed into one texture, diffuse with gloss and normal with specular
+		void SetDiffuseMap(const SoftwareTexture* pDiffuseMap);
+		void SetGlossMap(const SoftwareTexture* pGlossMap);
+		void SetNormalMap(const SoftwareTexture* pNormalMap);
+		void SetSpecularMap(const SoftwareTexture* pSpecularMap);
+
+		const SoftwareTexture* GetDiffuseMap() const { return m_pDiffuseMap; }
+		const SoftwareTexture* GetGlossMap() const { return m_pGlossMap; }
+		const SoftwareTexture* GetNormalMap() const { return m_pNormalMap; }
+		const SoftwareTexture* GetSpecularMap() const { return m_pSpecularMap; }
+
+		//Samples every material map, two fetches when the maps are packed and four otherwise
+		MaterialSample SampleMaterial(const Vector2& uv, const SamplerState& sampler) const;
+
+		//Vertex streams are padded to a multiple of this, so a transform kernel never needs a scalar tail
+		static constexpr int m_StreamAlignment{ 8 };
+
+	private:
+		VertexStreams m_VertexStreams{};
+		int m_VertexCount{};
+		std::vector<uint32_t> m_Indices{};
+		PrimitiveTopology m_PrimitiveTopology{ PrimitiveTopology::TriangleStrip };
+
+		std::vector<Vertex_Out> m_Vertices_out{};
+		TransformCache m_TransformCache{};
+
+		//Textures are not owned by the mesh
+		const SoftwareTexture* m_pDiffuseMap{};
+		const SoftwareTexture* m_pGlossMap{};
+		const SoftwareTexture* m_pNormalMap{};
+		const SoftwareTexture* m_pSpecularMap{};
+
+		//Owned packed copies of the maps, nullptr when a map is missing or the sizes don't match
+		SoftwareTexture* m_pDiffuseGlossMap{};
+		SoftwareTexture* m_pNormalSpecularMap{};
+
+		void PackDiffuseGlossMap();
+		void PackNormalSpecularMap();
+	};
+}
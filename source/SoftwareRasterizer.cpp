@@ -0,0 +1,1507 @@
+#include "pch.h"
+#include "SoftwareRasterizer.h"
+#include "SoftwareMesh.h"
+#include "SoftwareTexture.h"
+#include "ThreadPool.h"
+#include "Simd.h"
+
+namespace dae {
+
+	SoftwareRasterizer::SoftwareRasterizer(int width, int height, int numThreads) :
+		m_Width{ width },
+		m_Height{ height },
+		m_Stride{ (width + Simd::LaneCount - 1) / Simd::LaneCount * Simd::LaneCount }
+	{
+		//Create Buffers
+		m_pColorBufferPixels = new uint32_t[m_Stride * m_Height];
+		m_pDepthBufferPixels = new float[m_Stride * m_Height];
+		m_pVisibilityBufferPixels = new uint32_t[m_Stride * m_Height];
+
+		//Create hierarchical depth blocks, tiles are a multiple of the block size so every block belongs to one tile
+		static_assert(m_TileSize % m_DepthBlockSize == 0 && m_DepthBlockSize % Simd::LaneCount == 0);
+		m_NumDepthBlocksX = (m_Width + m_DepthBlockSize - 1) / m_DepthBlockSize;
+		m_NumDepthBlocksY = (m_Height + m_DepthBlockSize - 1) / m_DepthBlockSize;
+		m_pDepthBlockMin = new float[m_NumDepthBlocksX * m_NumDepthBlocksY];
+		m_pDepthBlockMax = new float[m_NumDepthBlocksX * m_NumDepthBlocksY];
+
+		//Create Tiles
+		m_NumTilesX = (m_Width + m_TileSize - 1) / m_TileSize;
+		m_NumTilesY = (m_Height + m_TileSize - 1) / m_TileSize;
+		m_Tiles.resize(m_NumTilesX * m_NumTilesY);
+
+		for (int tileY{}; tileY < m_NumTilesY; ++tileY)
+		{
+			for (int tileX{}; tileX < m_NumTilesX; ++tileX)
+			{
+				Tile& tile{ m_Tiles[tileX + tileY * m_NumTilesX] };
+				tile.minX = tileX * m_TileSize;
+				tile.minY = tileY * m_TileSize;
+				tile.maxX = std::min(tile.minX + m_TileSize, m_Width);
+				tile.maxY = std::min(tile.minY + m_TileSize, m_Height);
+			}
+		}
+
+		m_pThreadPool = new ThreadPool{ numThreads };
+
+		SetMatrices(m_WorldViewProjectionMatrix, m_WorldMatrix);
+	}
+
+	SoftwareRasterizer::~SoftwareRasterizer()
+	{
+		delete m_pThreadPool;
+
+		delete[] m_pColorBufferPixels;
+		delete[] m_pDepthBufferPixels;
+		delete[] m_pVisibilityBufferPixels;
+		delete[] m_pDepthBlockMin;
+		delete[] m_pDepthBlockMax;
+	}
+
+	int SoftwareRasterizer::GetNumThreads() const
+	{
+		return m_pThreadPool->GetNumThreads();
+	}
+
+	void SoftwareRasterizer::SetMatrices(const Matrix& worldViewProjection, const Matrix& worldMatrix)
+	{
+		m_WorldViewProjectionMatrix = worldViewProjection;
+		m_WorldMatrix = worldMatrix;
+
+		//The screen positions also depend on the size of the framebuffer
+		const int size[]{ m_Width, m_Height };
+		m_TransformKey = HashBytes(&m_WorldViewProjectionMatrix, sizeof(Matrix));
+		m_TransformKey = HashBytes(&m_WorldMatrix, sizeof(Matrix), m_TransformKey);
+		m_TransformKey = HashBytes(size, sizeof(size), m_TransformKey);
+	}
+
+	uint64_t SoftwareRasterizer::HashBytes(const void* pData, size_t size, uint64_t hash)
+	{
+		const uint8_t* pBytes{ static_cast<const uint8_t*>(pData) };
+
+		for (size_t i{}; i < size; ++i)
+		{
+			hash = (hash ^ pBytes[i]) * 1099511628211ull;
+		}
+
+		return hash != 0 ? hash : 1;
+	}
+
+	void SoftwareRasterizer::ClearBuffers(const ColorRGB& clearColor)
+	{
+		//Nothing is written here, the tiles clear themselves when they are first drawn into
+		const uint32_t packedClearColor{ PackColor(clearColor) };
+		const bool isSameColor{ packedClearColor == m_ClearColor };
+		m_ClearColor = packedClearColor;
+
+		m_AssemblyCullStats = {};
+
+		for (auto& tile : m_Tiles)
+		{
+			tile.cullStats = {};
+			tile.overdrawStats = {};
+
+			tile.needsClear = true;
+			tile.colorIsClear = tile.colorIsClear && isSameColor;
+		}
+	}
+
+	void SoftwareRasterizer::ClearTile(Tile& tile) const
+	{
+		if (!tile.colorIsClear)
+			ClearTileColor(tile);
+
+		for (int py{ tile.minY }; py < tile.maxY; ++py)
+		{
+			std::fill(m_pDepthBufferPixels + tile.minX + py * m_Stride, m_pDepthBufferPixels + tile.maxX + py * m_Stride, FLT_MAX);
+		}
+
+		//Tiles are a multiple of the block size, only the last row and column of blocks can be cut off by the screen
+		const int lastBlockX{ (tile.maxX + m_DepthBlockSize - 1) / m_DepthBlockSize };
+		const int lastBlockY{ (tile.maxY + m_DepthBlockSize - 1) / m_DepthBlockSize };
+		for (int blockY{ tile.minY / m_DepthBlockSize }; blockY < lastBlockY; ++blockY)
+		{
+			const int firstBlockIdx{ tile.minX / m_DepthBlockSize + blockY * m_NumDepthBlocksX };
+			const int lastBlockIdx{ lastBlockX + blockY * m_NumDepthBlocksX };
+
+			std::fill(m_pDepthBlockMin + firstBlockIdx, m_pDepthBlockMin + lastBlockIdx, FLT_MAX);
+			std::fill(m_pDepthBlockMax + firstBlockIdx, m_pDepthBlockMax + lastBlockIdx, FLT_MAX);
+		}
+
+		tile.needsClear = false;
+	}
+
+	void SoftwareRasterizer::ClearTileColor(Tile& tile) const
+	{
+		for (int py{ tile.minY }; py < tile.maxY; ++py)
+		{
+			std::fill(m_pColorBufferPixels + tile.minX + py * m_Stride, m_pColorBufferPixels + tile.maxX + py * m_Stride, m_ClearColor);
+		}
+
+		tile.colorIsClear = true;
+	}
+
+	uint32_t* SoftwareRasterizer::GetColorBuffer()
+	{
+		for (Tile& tile : m_Tiles)
+		{
+			if (tile.needsClear && !tile.colorIsClear)
+				ClearTileColor(tile);
+		}
+
+		return m_pColorBufferPixels;
+	}
+
+	float* SoftwareRasterizer::GetDepthBuffer()
+	{
+		for (Tile& tile : m_Tiles)
+		{
+			if (tile.needsClear)
+				ClearTile(tile);
+		}
+
+		return m_pDepthBufferPixels;
+	}
+
+	CullStats SoftwareRasterizer::GetCullStats() const
+	{
+		CullStats cullStats{ m_AssemblyCullStats };
+
+		for (const auto& tile : m_Tiles)
+		{
+			cullStats.trianglesTested += tile.cullStats.trianglesTested;
+			cullStats.trianglesCulled += tile.cullStats.trianglesCulled;
+			cullStats.blocksTested += tile.cullStats.blocksTested;
+			cullStats.blocksCulled += tile.cullStats.blocksCulled;
+		}
+
+		return cullStats;
+	}
+
+	OverdrawStats SoftwareRasterizer::GetOverdrawStats() const
+	{
+		OverdrawStats overdrawStats{};
+
+		for (const auto& tile : m_Tiles)
+		{
+			overdrawStats.pixelsWritten += tile.overdrawStats.pixelsWritten;
+			overdrawStats.pixelsShaded += tile.overdrawStats.pixelsShaded;
+		}
+
+		return overdrawStats;
+	}
+
+	uint32_t SoftwareRasterizer::PackColor(const ColorRGB& color)
+	{
+		return static_cast<uint32_t>(static_cast<uint8_t>(color.r * 255)) << 16 |
+			static_cast<uint32_t>(static_cast<uint8_t>(color.g * 255)) << 8 |
+			static_cast<uint32_t>(static_cast<uint8_t>(color.b * 255));
+	}
+
+	void SoftwareRasterizer::RenderMesh(SoftwareMesh& mesh)
+	{
+		TransformCache& cache{ mesh.GetTransformCache() };
+
+		//Transform, classify and project the vertices in batches, every batch writes its own range
+		//Skipped when the mesh was already transformed with the current matrices
+		if (cache.transformKey != m_TransformKey)
+		{
+			const int numVertices{ mesh.GetVertexCount() };
+
+			cache.vertices_Projected.resize(numVertices);
+			cache.vertices_ScreenSpace.resize(numVertices);
+			cache.clipCodes.resize(numVertices);
+
+			const int numBatches{ (numVertices + m_VertexBatchSize - 1) / m_VertexBatchSize };
+			m_pThreadPool->ParallelFor(numBatches, [this, &mesh, numVertices](int batchIdx)
+				{
+					const int firstVertex{ batchIdx * m_VertexBatchSize };
+					const int lastVertex{ std::min(firstVertex + m_VertexBatchSize, numVertices) };
+
+					VertexTransformationFunction(mesh, firstVertex, lastVertex);
+					ClipAndProjectVertices(mesh, firstVertex, lastVertex);
+				});
+
+			cache.transformKey = m_TransformKey;
+			cache.cullKey = 0;
+		}
+
+		//Cull the triangles in batches, every batch writes the flags of its own range
+		//The flags also depend on the cull mode, they are kept while neither changed
+		const uint64_t cullKey{ HashBytes(&m_CullMode, sizeof(m_CullMode), m_TransformKey) };
+
+		auto& indices{ mesh.GetIndices() };
+		const int stride{ mesh.GetTopology() == PrimitiveTopology::TriangeList ? 3 : 1 };
+		const int numTriangles{ indices.size() >= 3 ? (static_cast<int>(indices.size()) - 3) / stride + 1 : 0 };
+		const int numTriangleBatches{ (numTriangles + m_TriangleBatchSize - 1) / m_TriangleBatchSize };
+
+		if (cache.cullKey != cullKey)
+		{
+			cache.triangleFlags.resize(numTriangles);
+
+			m_pThreadPool->ParallelFor(numTriangleBatches, [this, &mesh, numTriangles](int batchIdx)
+				{
+					const int firstTriangle{ batchIdx * m_TriangleBatchSize };
+					CullTriangles(mesh, firstTriangle, std::min(firstTriangle + m_TriangleBatchSize, numTriangles));
+				});
+
+			cache.cullKey = cullKey;
+		}
+
+		//Clipping and finding the tiles of every triangle run in the same batches, only gathering them into the tiles is serial
+		if (static_cast<int>(m_AssemblyBatches.size()) < numTriangleBatches)
+			m_AssemblyBatches.resize(numTriangleBatches);
+
+		m_pThreadPool->ParallelFor(numTriangleBatches, [this, &mesh, numTriangles](int batchIdx)
+			{
+				const int firstTriangle{ batchIdx * m_TriangleBatchSize };
+				AssembleTriangles(mesh, m_AssemblyBatches[batchIdx], firstTriangle, std::min(firstTriangle + m_TriangleBatchSize, numTriangles));
+			});
+
+		BinTriangles(numTriangleBatches);
+
+		if (m_UseVisibilityBuffer)
+		{
+			//Same growth as the tile list, a slightly bigger frame doesn't have to grow it again
+			if (m_TileTriangles.size() > m_TriangleSetups.capacity())
+				m_TriangleSetups.reserve(m_TileTriangles.size() + m_TileTriangles.size() / 2);
+
+			m_TriangleSetups.resize(m_TileTriangles.size());
+		}
+
+		const RenderTileFunction renderTile{ SelectRenderTile() };
+		m_pThreadPool->ParallelFor(static_cast<int>(m_Tiles.size()), [this, &mesh, renderTile](int tileIdx)
+			{
+				(this->*renderTile)(m_Tiles[tileIdx], mesh);
+			});
+	}
+
+	SoftwareRasterizer::RenderTileFunction SoftwareRasterizer::SelectRenderTile() const
+	{
+		//Same priority as the visualizations had inside the pixel loop, the bounding boxes hide everything else
+		if (m_RenderBoundingBox)
+			return &SoftwareRasterizer::RenderTile<RenderStateKey{ .renderBoundingBox = true }>;
+
+		if (m_RenderDepth)
+			return &SoftwareRasterizer::RenderTile<RenderStateKey{ .renderDepth = true }>;
+
+		switch (m_ShadingMode)
+		{
+		case ShadingMode::ObservedArea:
+			return SelectShadedRenderTile<ShadingMode::ObservedArea>();
+		case ShadingMode::Diffuse:
+			return SelectShadedRenderTile<ShadingMode::Diffuse>();
+		case ShadingMode::Specular:
+			return SelectShadedRenderTile<ShadingMode::Specular>();
+		case ShadingMode::Combined:
+		default:
+			return SelectShadedRenderTile<ShadingMode::Combined>();
+		}
+	}
+
+	template<ShadingMode TShadingMode>
+	SoftwareRasterizer::RenderTileFunction SoftwareRasterizer::SelectShadedRenderTile() const
+	{
+		if (m_UseVisibilityBuffer)
+		{
+			if (m_UseNormalMap)
+				return &SoftwareRasterizer::RenderTile<RenderStateKey{ .shadingMode = TShadingMode, .useNormalMap = true, .visibilityBuffer = true }>;
+
+			return &SoftwareRasterizer::RenderTile<RenderStateKey{ .shadingMode = TShadingMode, .useNormalMap = false, .visibilityBuffer = true }>;
+		}
+
+		if (m_UseNormalMap)
+			return &SoftwareRasterizer::RenderTile<RenderStateKey{ TShadingMode, true }>;
+
+		return &SoftwareRasterizer::RenderTile<RenderStateKey{ TShadingMode, false }>;
+	}
+
+	void SoftwareRasterizer::ClipAndProjectVertices(SoftwareMesh& mesh, int firstVertex, int lastVertex)
+	{
+		auto& vertices_out{ mesh.GetVerticesOut() };
+		TransformCache& cache{ mesh.GetTransformCache() };
+
+		for (int vertexIdx{ firstVertex }; vertexIdx < lastVertex; ++vertexIdx)
+		{
+			const Vector4& position{ vertices_out[vertexIdx].position };
+
+			cache.clipCodes[vertexIdx] = CalculateClipCode(position);
+
+			//Vertices in front of the camera are projected, the others are only used after clipping
+			if (position.w > 0.f)
+			{
+				cache.vertices_Projected[vertexIdx] = { position.x / position.w, position.y / position.w, position.z / position.w, position.w };
+				cache.vertices_ScreenSpace[vertexIdx] = NdcToScreen(cache.vertices_Projected[vertexIdx]);
+			}
+		}
+	}
+
+	uint16_t SoftwareRasterizer::CalculateClipCode(const Vector4& position) const
+	{
+		const float guardBand{ m_GuardBand * position.w };
+
+		uint16_t clipCode{};
+
+		if (position.x < -position.w) clipCode |= m_ClipLeft;
+		if (position.x > position.w) clipCode |= m_ClipRight;
+		if (position.y < -position.w) clipCode |= m_ClipBottom;
+		if (position.y > position.w) clipCode |= m_ClipTop;
+		if (position.z < m_NearClipDepth * position.w) clipCode |= m_ClipNear;
+		if (position.z > position.w) clipCode |= m_ClipFar;
+
+		if (position.x < -guardBand) clipCode |= m_ClipGuardLeft;
+		if (position.x > guardBand) clipCode |= m_ClipGuardRight;
+		if (position.y < -guardBand) clipCode |= m_ClipGuardBottom;
+		if (position.y > guardBand) clipCode |= m_ClipGuardTop;
+
+		return clipCode;
+	}
+
+	Vector2 SoftwareRasterizer::NdcToScreen(const Vector4& position) const
+	{
+		return
+		{
+			(position.x + 1) / 2.0f * m_Width,
+			(1.0f - position.y) / 2.0f * m_Height
+		};
+	}
+
+	void SoftwareRasterizer::CullTriangles(SoftwareMesh& mesh, int firstTriangle, int lastTriangle)
+	{
+		auto& indices{ mesh.GetIndices() };
+		TransformCache& cache{ mesh.GetTransformCache() };
+		const int stride{ mesh.GetTopology() == PrimitiveTopology::TriangeList ? 3 : 1 };
+
+		for (int triangleIdx{ firstTriangle }; triangleIdx < lastTriangle; ++triangleIdx)
+		{
+			const int startIdx{ triangleIdx * stride };
+
+			//Every odd triangle of a strip has its winding flipped
+			const bool flipTriangle{ mesh.GetTopology() == PrimitiveTopology::TriangleStrip && (startIdx % 2) == 1 };
+
+			const uint32_t index0{ indices[startIdx] };
+			const uint32_t index1{ indices[startIdx + 1 + 1 * flipTriangle] };
+			const uint32_t index2{ indices[startIdx + 1 + 1 * !flipTriangle] };
+
+			uint8_t& triangleFlags{ cache.triangleFlags[triangleIdx] };
+
+			if (index0 == index1 || index1 == index2 || index2 == index0)
+			{
+				triangleFlags = m_TriangleCulled;
+				continue;
+			}
+
+			const uint16_t clipCode0{ cache.clipCodes[index0] };
+			const uint16_t clipCode1{ cache.clipCodes[index1] };
+			const uint16_t clipCode2{ cache.clipCodes[index2] };
+
+			//All vertices outside the same plane, nothing of the triangle is visible
+			if ((clipCode0 & clipCode1 & clipCode2) != 0)
+			{
+				triangleFlags = m_TriangleCulled;
+				continue;
+			}
+
+			//The screen positions of these aren't valid yet, they are culled after clipping
+			if (((clipCode0 | clipCode1 | clipCode2) & m_ClipMask) != 0)
+			{
+				triangleFlags = m_TriangleNeedsClipping;
+				continue;
+			}
+
+			triangleFlags = CalculateCullFlags(cache.vertices_ScreenSpace[index0], cache.vertices_ScreenSpace[index1], cache.vertices_ScreenSpace[index2]);
+		}
+	}
+
+	uint8_t SoftwareRasterizer::CalculateCullFlags(const Vector2& screen0, const Vector2& screen1, const Vector2& screen2) const
+	{
+		//Same snapped positions as RenderTriangle so both agree on the winding and covered pixels
+		const Vector2 v0{ SnapToSubpixel(screen0) };
+		const Vector2 v1{ SnapToSubpixel(screen1) };
+		const Vector2 v2{ SnapToSubpixel(screen2) };
+
+		//Degenerate triangles cover no pixels
+		const float triangleArea{ Vector2::Cross(v2 - v1, v0 - v2) };
+		if (triangleArea == 0.f)
+			return m_TriangleCulled;
+
+		//Triangles too small to contain a pixel center cover no pixels
+		const float minX{ std::min({ v0.x, v1.x, v2.x }) };
+		const float minY{ std::min({ v0.y, v1.y, v2.y }) };
+		const float maxX{ std::max({ v0.x, v1.x, v2.x }) };
+		const float maxY{ std::max({ v0.y, v1.y, v2.y }) };
+
+		if (std::ceil(minX - .5f) > std::floor(maxX - .5f) || std::ceil(minY - .5f) > std::floor(maxY - .5f))
+			return m_TriangleCulled;
+
+		//Clockwise triangles on screen are front facing, same as the default D3D rasterizer state
+		const bool isFrontFacing{ triangleArea > 0.f };
+
+		switch (m_CullMode)
+		{
+		case CullMode::Back:
+			return isFrontFacing ? 0 : m_TriangleCulled | m_TriangleFacingCulled;
+		case CullMode::Front:
+			return isFrontFacing ? m_TriangleCulled | m_TriangleFacingCulled : m_TriangleFlipped;
+		case CullMode::None:
+		default:
+			return isFrontFacing ? 0 : m_TriangleFlipped;
+		}
+	}
+
+	Vector2 SoftwareRasterizer::SnapToSubpixel(const Vector2& position)
+	{
+		//Same result as std::round, which is a library call that isn't inlined. Triangle setup runs between the SIMD loops,
+		//a legacy SSE call while the wide registers are still dirty costs a state transition every time
+		const auto round{ [](float value)
+			{
+				const float truncated{ std::trunc(value) };
+				return std::abs(value - truncated) >= .5f ? truncated + std::copysign(1.f, value) : truncated;
+			} };
+
+		return { round(position.x * m_SubpixelSteps) / m_SubpixelSteps, round(position.y * m_SubpixelSteps) / m_SubpixelSteps };
+	}
+
+	void SoftwareRasterizer::AssembleTriangles(SoftwareMesh& mesh, AssemblyBatch& batch, int firstTriangle, int lastTriangle) const
+	{
+		batch.binnedTriangles.clear();
+		batch.clippedVertices.clear();
+		batch.clippedVertices_ScreenSpace.clear();
+		batch.cullStats = {};
+		batch.cullStats.trianglesSubmitted = lastTriangle - firstTriangle;
+
+		auto& indices{ mesh.GetIndices() };
+		auto& vertices_out{ mesh.GetVerticesOut() };
+		TransformCache& cache{ mesh.GetTransformCache() };
+		const int stride{ mesh.GetTopology() == PrimitiveTopology::TriangeList ? 3 : 1 };
+
+		//Only clipped triangles can add more, the list grows until it fits the largest frame
+		batch.binnedTriangles.reserve(lastTriangle - firstTriangle);
+
+		for (int triangleIdx{ firstTriangle }; triangleIdx < lastTriangle; ++triangleIdx)
+		{
+			const uint8_t triangleFlags{ cache.triangleFlags[triangleIdx] };
+
+			if ((triangleFlags & m_TriangleCulled) != 0)
+			{
+				batch.cullStats.trianglesFacingCulled += (triangleFlags & m_TriangleFacingCulled) != 0;
+				continue;
+			}
+
+			const int startIdx{ triangleIdx * stride };
+
+			//Triangles crossing the near or far plane or leaving the guard band are clipped in homogeneous space
+			//and culled afterwards, every other triangle is rasterized as is and only clipped to the screen by its bounding box
+			if ((triangleFlags & m_TriangleNeedsClipping) != 0)
+			{
+				//Every odd triangle of a strip has its winding flipped
+				const bool flipTriangle{ mesh.GetTopology() == PrimitiveTopology::TriangleStrip && (startIdx % 2) == 1 };
+
+				const uint32_t firstClipped{ static_cast<uint32_t>(batch.clippedVertices.size() / 3) };
+
+				ClipTriangle(vertices_out[indices[startIdx]], vertices_out[indices[startIdx + 1 + 1 * flipTriangle]],
+					vertices_out[indices[startIdx + 1 + 1 * !flipTriangle]], batch);
+
+				//The parts of a clipped triangle lie in its plane, the triangle counts as facing culled once when they are
+				bool isFacingCulled{};
+
+				const uint32_t lastClipped{ static_cast<uint32_t>(batch.clippedVertices.size() / 3) };
+				for (uint32_t clippedIdx{ firstClipped }; clippedIdx < lastClipped; ++clippedIdx)
+				{
+					const Vector2* pScreen{ &batch.clippedVertices_ScreenSpace[clippedIdx * 3] };
+					const uint8_t clippedFlags{ CalculateCullFlags(pScreen[0], pScreen[1], pScreen[2]) };
+
+					if ((clippedFlags & m_TriangleCulled) != 0)
+					{
+						isFacingCulled = isFacingCulled || (clippedFlags & m_TriangleFacingCulled) != 0;
+						continue;
+					}
+
+					//Indexes the batch's clipped vertices, BinTriangles offsets it into m_ClippedVertices
+					const uint32_t clippedTriangleIdx{ clippedIdx | m_ClippedTriangleBit | ((clippedFlags & m_TriangleFlipped) != 0 ? m_FlippedTriangleBit : 0) };
+					BinTriangle(GetBoundingBox(pScreen[0], pScreen[1], pScreen[2]), clippedTriangleIdx, batch);
+				}
+
+				batch.cullStats.trianglesFacingCulled += isFacingCulled;
+				continue;
+			}
+
+			const uint32_t binnedIdx{ static_cast<uint32_t>(startIdx) | ((triangleFlags & m_TriangleFlipped) != 0 ? m_FlippedTriangleBit : 0) };
+			BinTriangle(GetBoundingBox(cache.vertices_ScreenSpace[indices[startIdx]], cache.vertices_ScreenSpace[indices[startIdx + 1]],
+				cache.vertices_ScreenSpace[indices[startIdx + 2]]), binnedIdx, batch);
+		}
+	}
+
+	void SoftwareRasterizer::BinTriangles(int numBatches)
+	{
+		for (auto& tile : m_Tiles)
+		{
+			tile.numTriangles = 0;
+		}
+
+		m_ClippedVertices.clear();
+		m_ClippedVertices_ScreenSpace.clear();
+
+		//Gather the clipped vertices of every batch and count the triangles of every tile
+		for (int batchIdx{}; batchIdx < numBatches; ++batchIdx)
+		{
+			AssemblyBatch& batch{ m_AssemblyBatches[batchIdx] };
+			const uint32_t firstClipped{ static_cast<uint32_t>(m_ClippedVertices.size() / 3) };
+
+			m_AssemblyCullStats.trianglesSubmitted += batch.cullStats.trianglesSubmitted;
+			m_AssemblyCullStats.trianglesFacingCulled += batch.cullStats.trianglesFacingCulled;
+
+			m_ClippedVertices.insert(m_ClippedVertices.end(), batch.clippedVertices.begin(), batch.clippedVertices.end());
+			m_ClippedVertices_ScreenSpace.insert(m_ClippedVertices_ScreenSpace.end(), batch.clippedVertices_ScreenSpace.begin(), batch.clippedVertices_ScreenSpace.end());
+
+			for (BinnedTriangle& binnedTriangle : batch.binnedTriangles)
+			{
+				if ((binnedTriangle.triangleIdx & m_ClippedTriangleBit) != 0)
+					binnedTriangle.triangleIdx += firstClipped;
+
+				for (int tileY{ binnedTriangle.minTileY }; tileY <= binnedTriangle.maxTileY; ++tileY)
+				{
+					for (int tileX{ binnedTriangle.minTileX }; tileX <= binnedTriangle.maxTileX; ++tileX)
+					{
+						++m_Tiles[tileX + tileY * m_NumTilesX].numTriangles;
+					}
+				}
+			}
+		}
+
+		//Counting sort into one shared list, every tile gets a contiguous range in submission order
+		int numTileTriangles{};
+		for (auto& tile : m_Tiles)
+		{
+			tile.firstTriangle = numTileTriangles;
+			numTileTriangles += tile.numTriangles;
+			tile.numTriangles = 0;
+		}
+
+		//Leave some room so a slightly bigger frame doesn't have to grow the list again
+		if (numTileTriangles > static_cast<int>(m_TileTriangles.capacity()))
+			m_TileTriangles.reserve(numTileTriangles + numTileTriangles / 2);
+
+		m_TileTriangles.resize(numTileTriangles);
+
+		for (int batchIdx{}; batchIdx < numBatches; ++batchIdx)
+		{
+			for (const BinnedTriangle& binnedTriangle : m_AssemblyBatches[batchIdx].binnedTriangles)
+			{
+				for (int tileY{ binnedTriangle.minTileY }; tileY <= binnedTriangle.maxTileY; ++tileY)
+				{
+					for (int tileX{ binnedTriangle.minTileX }; tileX <= binnedTriangle.maxTileX; ++tileX)
+					{
+						Tile& tile{ m_Tiles[tileX + tileY * m_NumTilesX] };
+						m_TileTriangles[tile.firstTriangle + tile.numTriangles++] = binnedTriangle.triangleIdx;
+					}
+				}
+			}
+		}
+	}
+
+	void SoftwareRasterizer::BinTriangle(const BoundingBox& box, uint32_t triangleIdx, AssemblyBatch& batch) const
+	{
+		if (box.minX >= box.maxX || box.minY >= box.maxY)
+			return;
+
+		batch.binnedTriangles.push_back(BinnedTriangle
+			{
+				triangleIdx,
+				box.minX / m_TileSize,
+				box.minY / m_TileSize,
+				(box.maxX - 1) / m_TileSize,
+				(box.maxY - 1) / m_TileSize
+			});
+	}
+
+	void SoftwareRasterizer::ClipTriangle(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, AssemblyBatch& batch) const
+	{
+		//Sutherland-Hodgman, every plane can add at most one vertex to the polygon
+		constexpr int numPlanes{ 6 };
+		constexpr int maxVertices{ 3 + numPlanes };
+
+		Vertex_Out polygons[2][maxVertices]{ { v0, v1, v2 } };
+		int numVertices{ 3 };
+		int current{};
+
+		//Signed distance to each clip plane, positive is inside
+		const auto planeDistance{ [this](const Vector4& position, int plane)
+			{
+				switch (plane)
+				{
+				case 0: return position.z - m_NearClipDepth * position.w;
+				case 1: return position.w - position.z;
+				case 2: return position.x + m_GuardBand * position.w;
+				case 3: return m_GuardBand * position.w - position.x;
+				case 4: return position.y + m_GuardBand * position.w;
+				default: return m_GuardBand * position.w - position.y;
+				}
+			} };
+
+		const auto lerpVertex{ [](const Vertex_Out& from, const Vertex_Out& to, float factor)
+			{
+				return Vertex_Out
+				{
+					from.position + (to.position - from.position) * factor,
+					from.uv + (to.uv - from.uv) * factor,
+					from.normal + (to.normal - from.normal) * factor,
+					from.tangent + (to.tangent - from.tangent) * factor,
+					from.viewDirection + (to.viewDirection - from.viewDirection) * factor
+				};
+			} };
+
+		for (int plane{}; plane < numPlanes && numVertices > 0; ++plane)
+		{
+			const Vertex_Out* pInput{ polygons[current] };
+			Vertex_Out* pOutput{ polygons[1 - current] };
+			int numOutput{};
+
+			for (int vertexIdx{}; vertexIdx < numVertices; ++vertexIdx)
+			{
+				const Vertex_Out& from{ pInput[vertexIdx] };
+				const Vertex_Out& to{ pInput[(vertexIdx + 1) % numVertices] };
+
+				const float fromDistance{ planeDistance(from.position, plane) };
+				const float toDistance{ planeDistance(to.position, plane) };
+
+				if (fromDistance >= 0.f)
+					pOutput[numOutput++] = from;
+
+				if ((fromDistance >= 0.f) != (toDistance >= 0.f))
+					pOutput[numOutput++] = lerpVertex(from, to, fromDistance / (fromDistance - toDistance));
+			}
+
+			numVertices = numOutput;
+			current = 1 - current;
+		}
+
+		//Triangulate the convex polygon as a fan, which keeps the winding of the original triangle
+		for (int vertexIdx{ 1 }; vertexIdx + 1 < numVertices; ++vertexIdx)
+		{
+			for (const Vertex_Out* pVertex : { &polygons[current][0], &polygons[current][vertexIdx], &polygons[current][vertexIdx + 1] })
+			{
+				Vertex_Out vertex{ *pVertex };
+				const float w{ vertex.position.w };
+				vertex.position = { vertex.position.x / w, vertex.position.y / w, vertex.position.z / w, w };
+
+				batch.clippedVertices.push_back(vertex);
+				batch.clippedVertices_ScreenSpace.push_back(NdcToScreen(vertex.position));
+			}
+		}
+	}
+
+	template<RenderStateKey Key>
+	void SoftwareRasterizer::RenderTile(Tile& tile, SoftwareMesh& mesh) const
+	{
+		//A tile without triangles only has to show the clear color, its depth is cleared by the first draw into it
+		if (tile.numTriangles == 0)
+		{
+			if (tile.needsClear && !tile.colorIsClear)
+				ClearTileColor(tile);
+
+			return;
+		}
+
+		if (tile.needsClear)
+			ClearTile(tile);
+
+		//The triangles are drawn right after, the color won't hold the clear color anymore
+		tile.colorIsClear = false;
+
+		if constexpr (Key.visibilityBuffer)
+		{
+			for (int py{ tile.minY }; py < tile.maxY; ++py)
+			{
+				std::fill(m_pVisibilityBufferPixels + tile.minX + py * m_Stride, m_pVisibilityBufferPixels + tile.maxX + py * m_Stride, m_NoTriangle);
+			}
+		}
+
+		Triangle triangle{};
+
+		for (int triangleIdx{ tile.firstTriangle }; triangleIdx < tile.firstTriangle + tile.numTriangles; ++triangleIdx)
+		{
+			const uint32_t startIdx{ m_TileTriangles[triangleIdx] };
+
+			//A degenerate triangle would otherwise rasterize whatever the previous one left in triangle
+			if (!CalculateTriangle(triangle, mesh, startIdx))
+				continue;
+
+			RenderTriangle<Key>(triangle, triangleIdx, mesh, tile);
+		}
+
+		//Every triangle of the tile is rasterized, only the visible ones are left in the visibility buffer
+		if constexpr (Key.visibilityBuffer)
+		{
+			ResolveTile<Key>(tile, mesh);
+		}
+	}
+
+	bool SoftwareRasterizer::CalculateTriangle(Triangle& triangle, SoftwareMesh& mesh, uint32_t startIdx) const
+	{
+		//Culling keeps back facing triangles by swapping two vertices so they are always rasterized clockwise
+		const bool swapWinding{ (startIdx & m_FlippedTriangleBit) != 0 };
+		startIdx &= ~m_FlippedTriangleBit;
+
+		//Clipped triangles are stored as three consecutive vertices
+		if ((startIdx & m_ClippedTriangleBit) != 0)
+		{
+			const uint32_t firstVertex{ (startIdx & ~m_ClippedTriangleBit) * 3 };
+
+			triangle.screen[0] = m_ClippedVertices_ScreenSpace[firstVertex];
+			triangle.screen[1] = m_ClippedVertices_ScreenSpace[firstVertex + 1 + 1 * swapWinding];
+			triangle.screen[2] = m_ClippedVertices_ScreenSpace[firstVertex + 1 + 1 * !swapWinding];
+
+			triangle.ndc[0] = m_ClippedVertices[firstVertex];
+			triangle.ndc[1] = m_ClippedVertices[firstVertex + 1 + 1 * swapWinding];
+			triangle.ndc[2] = m_ClippedVertices[firstVertex + 1 + 1 * !swapWinding];
+
+			triangle.boundingBox = GetBoundingBox(triangle.screen[0], triangle.screen[1], triangle.screen[2]);
+
+			return true;
+		}
+
+		auto& indices{ mesh.GetIndices() };
+		auto& vertices_out{ mesh.GetVerticesOut() };
+		TransformCache& cache{ mesh.GetTransformCache() };
+
+		//Every odd triangle of a strip has its winding flipped
+		const bool flipTriangle{ (mesh.GetTopology() == PrimitiveTopology::TriangleStrip && (startIdx % 2) == 1) != swapWinding };
+
+		const uint32_t index0{ indices[startIdx] };
+		const uint32_t index1{ indices[startIdx + 1 + 1 * flipTriangle] };
+		const uint32_t index2{ indices[startIdx + 1 + 1 * !flipTriangle] };
+
+		if (index0 == index1 || index1 == index2 || index2 == index0)return false;
+
+		triangle.screen[0] = { cache.vertices_ScreenSpace[index0] };
+		triangle.screen[1] = { cache.vertices_ScreenSpace[index1] };
+		triangle.screen[2] = { cache.vertices_ScreenSpace[index2] };
+
+		triangle.ndc[0] = vertices_out[index0];
+		triangle.ndc[1] = vertices_out[index1];
+		triangle.ndc[2] = vertices_out[index2];
+
+		triangle.ndc[0].position = cache.vertices_Projected[index0];
+		triangle.ndc[1].position = cache.vertices_Projected[index1];
+		triangle.ndc[2].position = cache.vertices_Projected[index2];
+
+		triangle.boundingBox = GetBoundingBox(triangle.screen[0], triangle.screen[1], triangle.screen[2]);
+
+		return true;
+	}
+
+	template<RenderStateKey Key>
+	void SoftwareRasterizer::RenderTriangle(const Triangle& triangle, int tileTriangleIdx, const SoftwareMesh& mesh, Tile& tile) const
+	{
+		if constexpr (Key.renderBoundingBox)
+		{
+			//Only touch the pixels owned by this tile
+			const int minX{ std::max(triangle.boundingBox.minX, tile.minX) };
+			const int minY{ std::max(triangle.boundingBox.minY, tile.minY) };
+			const int maxX{ std::min(triangle.boundingBox.maxX, tile.maxX) };
+			const int maxY{ std::min(triangle.boundingBox.maxY, tile.maxY) };
+
+			if (minX >= maxX || minY >= maxY)
+				return;
+
+			const uint32_t packedColor{ PackColor(ColorRGB{ 1, 1, 1 }) };
+
+			for (int py{ minY }; py < maxY; ++py)
+			{
+				std::fill(m_pColorBufferPixels + minX + py * m_Stride, m_pColorBufferPixels + maxX + py * m_Stride, packedColor);
+			}
+			return;
+		}
+
+		//The visibility buffer keeps the setup of every binned triangle for the shading after rasterization
+		TriangleSetup localSetup{};
+		TriangleSetup& setup{ Key.visibilityBuffer ? m_TriangleSetups[tileTriangleIdx] : localSetup };
+		if (!SetupTriangle(triangle, tile, setup))
+			return;
+
+		const int minX{ setup.minX };
+		const int minY{ setup.minY };
+		const int maxX{ setup.maxX };
+		const int maxY{ setup.maxY };
+
+		//Hierarchical depth test, the interpolated depth always lies between the vertex depths
+		//so when those are inside the depth range the triangle can be compared against whole blocks
+		const float triangleMinZ{ std::min({ triangle.ndc[0].position.z, triangle.ndc[1].position.z, triangle.ndc[2].position.z }) };
+		const float triangleMaxZ{ std::max({ triangle.ndc[0].position.z, triangle.ndc[1].position.z, triangle.ndc[2].position.z }) };
+		const bool useHierarchicalZ{ triangleMinZ > 0.f && triangleMaxZ <= 1.f };
+
+		if (useHierarchicalZ)
+		{
+			++tile.cullStats.trianglesTested;
+
+			bool isOccluded{ true };
+			for (int blockY{ minY / m_DepthBlockSize }; isOccluded && blockY <= (maxY - 1) / m_DepthBlockSize; ++blockY)
+			{
+				for (int blockX{ minX / m_DepthBlockSize }; isOccluded && blockX <= (maxX - 1) / m_DepthBlockSize; ++blockX)
+				{
+					isOccluded = triangleMinZ > m_pDepthBlockMax[blockX + blockY * m_NumDepthBlocksX];
+				}
+			}
+
+			if (isOccluded)
+			{
+				++tile.cullStats.trianglesCulled;
+				return;
+			}
+		}
+
+		const Simd::Float inverseZ0{ Simd::Set(setup.inverseZ[0]) };
+		const Simd::Float inverseZ1{ Simd::Set(setup.inverseZ[1]) };
+		const Simd::Float inverseZ2{ Simd::Set(setup.inverseZ[2]) };
+
+		const Simd::Float laneOffsets{ Simd::LaneOffsets() };
+		const Simd::Float minXLanes{ Simd::Set(static_cast<float>(minX)) };
+		const Simd::Float maxXLanes{ Simd::Set(static_cast<float>(maxX)) };
+
+		const Simd::Float groupStep01{ Simd::Set(-setup.edges[0].y * Simd::LaneCount) };
+		const Simd::Float groupStep12{ Simd::Set(-setup.edges[1].y * Simd::LaneCount) };
+		const Simd::Float groupStep20{ Simd::Set(-setup.edges[2].y * Simd::LaneCount) };
+
+		const Simd::Float bias01Lanes{ Simd::Set(setup.biases[0]) };
+		const Simd::Float bias12Lanes{ Simd::Set(setup.biases[1]) };
+		const Simd::Float bias20Lanes{ Simd::Set(setup.biases[2]) };
+
+		const Simd::Float inverseAreaLanes{ Simd::Set(setup.inverseTriangleArea) };
+		const Simd::Float zero{ Simd::Set(0.f) };
+		const Simd::Float one{ Simd::Set(1.f) };
+
+		for (int blockY{ minY / m_DepthBlockSize }; blockY <= (maxY - 1) / m_DepthBlockSize; ++blockY)
+		{
+			for (int blockX{ minX / m_DepthBlockSize }; blockX <= (maxX - 1) / m_DepthBlockSize; ++blockX)
+			{
+				const int blockIdx{ blockX + blockY * m_NumDepthBlocksX };
+
+				if (useHierarchicalZ)
+				{
+					++tile.cullStats.blocksTested;
+
+					//Every depth in the block is closer than the closest point of the triangle
+					if (triangleMinZ > m_pDepthBlockMax[blockIdx])
+					{
+						++tile.cullStats.blocksCulled;
+						continue;
+					}
+				}
+
+				//Every depth in the block is further away than the furthest point of the triangle, only the range test remains
+				const bool acceptBlock{ useHierarchicalZ && triangleMaxZ <= m_pDepthBlockMin[blockIdx] };
+				bool blockWritten{ false };
+
+				const int blockMinX{ std::max(minX, blockX * m_DepthBlockSize) };
+				const int blockMinY{ std::max(minY, blockY * m_DepthBlockSize) };
+				const int blockMaxX{ std::min(maxX, (blockX + 1) * m_DepthBlockSize) };
+				const int blockMaxY{ std::min(maxY, (blockY + 1) * m_DepthBlockSize) };
+
+				const int blockGroupMinX{ blockMinX / Simd::LaneCount * Simd::LaneCount };
+
+				for (int py{ blockMinY }; py < blockMaxY; ++py)
+				{
+					Simd::Float edgeFunctions[3];
+					CalculateEdgeFunctions(setup, blockGroupMinX, py, edgeFunctions);
+
+					Simd::Float& edge01PointCross{ edgeFunctions[0] };
+					Simd::Float& edge12PointCross{ edgeFunctions[1] };
+					Simd::Float& edge20PointCross{ edgeFunctions[2] };
+
+					for (int px{ blockGroupMinX }; px < blockMaxX; px += Simd::LaneCount,
+						edge01PointCross = Simd::Add(edge01PointCross, groupStep01),
+						edge12PointCross = Simd::Add(edge12PointCross, groupStep12),
+						edge20PointCross = Simd::Add(edge20PointCross, groupStep20))
+					{
+						const Simd::Float pixelX{ Simd::Add(Simd::Set(static_cast<float>(px)), laneOffsets) };
+
+						Simd::Float coverage{ Simd::And(Simd::GreaterEqual(pixelX, minXLanes), Simd::Less(pixelX, maxXLanes)) };
+						coverage = Simd::And(coverage, Simd::GreaterEqual(edge01PointCross, bias01Lanes));
+						coverage = Simd::And(coverage, Simd::GreaterEqual(edge12PointCross, bias12Lanes));
+						coverage = Simd::And(coverage, Simd::GreaterEqual(edge20PointCross, bias20Lanes));
+
+						if (Simd::MoveMask(coverage) == 0) continue;
+
+						const int pixelIdx{ px + py * m_Stride };
+
+						const Simd::Float weightV0{ Simd::Mul(edge12PointCross, inverseAreaLanes) };
+						const Simd::Float weightV1{ Simd::Mul(edge20PointCross, inverseAreaLanes) };
+						const Simd::Float weightV2{ Simd::Mul(edge01PointCross, inverseAreaLanes) };
+
+						const Simd::Float interpolatedZDepth{ Simd::Div(one,
+							Simd::MulAdd(weightV0, inverseZ0, Simd::MulAdd(weightV1, inverseZ1, Simd::Mul(weightV2, inverseZ2)))) };
+
+						//Depth test, lanes that fail keep their old depth
+						const Simd::Float oldDepth{ Simd::Load(m_pDepthBufferPixels + pixelIdx) };
+
+						Simd::Float depthPass{ Simd::And(coverage, Simd::GreaterEqual(interpolatedZDepth, zero)) };
+						depthPass = Simd::And(depthPass, Simd::LessEqual(interpolatedZDepth, one));
+						if (!acceptBlock)
+						{
+							depthPass = Simd::And(depthPass, Simd::GreaterEqual(oldDepth, interpolatedZDepth));
+						}
+
+						const int passMask{ Simd::MoveMask(depthPass) };
+						if (passMask == 0) continue;
+
+						Simd::Store(m_pDepthBufferPixels + pixelIdx, Simd::Select(depthPass, interpolatedZDepth, oldDepth));
+						blockWritten = true;
+
+						const int numPassed{ std::popcount(static_cast<uint32_t>(passMask)) };
+						tile.overdrawStats.pixelsWritten += numPassed;
+
+						if constexpr (Key.visibilityBuffer)
+						{
+							//Only remember which triangle is in front, it is shaded once the whole tile is rasterized
+							for (int lane{}; lane < Simd::LaneCount; ++lane)
+							{
+								if ((passMask & (1 << lane)) != 0)
+									m_pVisibilityBufferPixels[pixelIdx + lane] = static_cast<uint32_t>(tileTriangleIdx);
+							}
+						}
+						else
+						{
+							ShadePixels<Key>(setup, px, py, weightV0, weightV1, weightV2, interpolatedZDepth, passMask, mesh);
+							tile.overdrawStats.pixelsShaded += numPassed;
+						}
+					}
+				}
+
+				if (blockWritten)
+				{
+					UpdateDepthBlock(blockX, blockY);
+				}
+			}
+		}
+	}
+
+	bool SoftwareRasterizer::SetupTriangle(const Triangle& triangle, const Tile& tile, TriangleSetup& setup) const
+	{
+		//Only touch the pixels owned by this tile
+		setup.minX = std::max(triangle.boundingBox.minX, tile.minX);
+		setup.minY = std::max(triangle.boundingBox.minY, tile.minY);
+		setup.maxX = std::min(triangle.boundingBox.maxX, tile.maxX);
+		setup.maxY = std::min(triangle.boundingBox.maxY, tile.maxY);
+
+		if (setup.minX >= setup.maxX || setup.minY >= setup.maxY)
+			return false;
+
+		//Snap the vertices to a subpixel grid, all edge function values are then multiples of 1 / (steps * steps)
+		//so they are evaluated exactly and shared edges never leave gaps or get drawn twice
+		constexpr float edgeEpsilon{ 1.f / (m_SubpixelSteps * m_SubpixelSteps) };
+
+		const Vector2 v0{ SnapToSubpixel(triangle.screen[0]) };
+		const Vector2 v1{ SnapToSubpixel(triangle.screen[1]) };
+		const Vector2 v2{ SnapToSubpixel(triangle.screen[2]) };
+
+		const Vector2 edgeV0V1{ v1 - v0 };
+		const Vector2 edgeV1V2{ v2 - v1 };
+		const Vector2 edgeV2V0{ v0 - v2 };
+
+		//Culling already flipped or removed the triangles without a clockwise winding, this only guards the division below
+		const float triangleArea{ Vector2::Cross(edgeV1V2,edgeV2V0) };
+		if (triangleArea <= 0.f)
+			return false;
+
+		const float inverseTriangleArea{ 1.f / triangleArea };
+
+		setup.edges[0] = edgeV0V1;
+		setup.edges[1] = edgeV1V2;
+		setup.edges[2] = edgeV2V0;
+		setup.inverseTriangleArea = inverseTriangleArea;
+
+		//Top-left fill rule: a pixel center exactly on an edge only belongs to the triangle if it is a top or left edge
+		//(inside lies below a horizontal edge running right, or right of an edge running up)
+		const auto isTopLeft{ [](const Vector2& edge) { return edge.y < 0.f || (edge.y == 0.f && edge.x > 0.f); } };
+		setup.biases[0] = isTopLeft(edgeV0V1) ? 0.f : edgeEpsilon;
+		setup.biases[1] = isTopLeft(edgeV1V2) ? 0.f : edgeEpsilon;
+		setup.biases[2] = isTopLeft(edgeV2V0) ? 0.f : edgeEpsilon;
+
+		//Pixel groups start on a multiple of LaneCount, tiles are a multiple of LaneCount wide so a group never
+		//crosses into a tile owned by another worker, lanes outside the bounding box are masked out
+		setup.groupMinX = setup.minX / Simd::LaneCount * Simd::LaneCount;
+
+		//Edge functions at the center of the first pixel, stepping one pixel right adds -edge.y, one pixel down adds edge.x
+		const Vector2 startPoint{ setup.groupMinX + .5f, setup.minY + .5f };
+		setup.startEdges[0] = Vector2::Cross(edgeV0V1, startPoint - v0);
+		setup.startEdges[1] = Vector2::Cross(edgeV1V2, startPoint - v1);
+		setup.startEdges[2] = Vector2::Cross(edgeV2V0, startPoint - v2);
+
+		//Perspective correct interpolation: attributes are interpolated as attribute / w and divided by the interpolated 1 / w
+		for (int vertexIdx{}; vertexIdx < 3; ++vertexIdx)
+		{
+			setup.inverseZ[vertexIdx] = 1.f / triangle.ndc[vertexIdx].position.z;
+			setup.inverseW[vertexIdx] = 1.f / triangle.ndc[vertexIdx].position.w;
+		}
+
+		//Screen space uv derivatives for mip selection. uv / w and 1 / w are linear in screen space so
+		//d(uv)/dx = (d(uv / w)/dx - uv * d(1 / w)/dx) * w, which gives every pixel the exact derivative a 2x2 quad only approximates
+		const float weightDerivativesX[3]{ -edgeV1V2.y * inverseTriangleArea, -edgeV2V0.y * inverseTriangleArea, -edgeV0V1.y * inverseTriangleArea };
+		const float weightDerivativesY[3]{ edgeV1V2.x * inverseTriangleArea, edgeV2V0.x * inverseTriangleArea, edgeV0V1.x * inverseTriangleArea };
+
+		setup.inverseWDerivativeX = 0.f;
+		setup.inverseWDerivativeY = 0.f;
+		setup.uvOverWDerivativeX = {};
+		setup.uvOverWDerivativeY = {};
+		for (int vertexIdx{}; vertexIdx < 3; ++vertexIdx)
+		{
+			const float inverseW{ 1.f / triangle.ndc[vertexIdx].position.w };
+			setup.inverseWDerivativeX += weightDerivativesX[vertexIdx] * inverseW;
+			setup.inverseWDerivativeY += weightDerivativesY[vertexIdx] * inverseW;
+			setup.uvOverWDerivativeX += triangle.ndc[vertexIdx].uv * (weightDerivativesX[vertexIdx] * inverseW);
+			setup.uvOverWDerivativeY += triangle.ndc[vertexIdx].uv * (weightDerivativesY[vertexIdx] * inverseW);
+		}
+
+		for (int vertexIdx{}; vertexIdx < 3; ++vertexIdx)
+		{
+			const Vertex_Out& vertex{ triangle.ndc[vertexIdx] };
+			const float vertexAttribute[m_NumAttributes]
+			{
+				vertex.uv.x, vertex.uv.y,
+				vertex.normal.x, vertex.normal.y, vertex.normal.z,
+				vertex.tangent.x, vertex.tangent.y, vertex.tangent.z,
+				vertex.viewDirection.x, vertex.viewDirection.y, vertex.viewDirection.z
+			};
+			std::copy(vertexAttribute, vertexAttribute + m_NumAttributes, setup.vertexAttributes[vertexIdx]);
+		}
+
+		return true;
+	}
+
+	void SoftwareRasterizer::CalculateEdgeFunctions(const TriangleSetup& setup, int px, int py, Simd::Float(&edgeFunctions)[3]) const
+	{
+		//The rasterization loop starts every row at the first group of a depth block and steps right from there,
+		//taking the same steps keeps the values bit identical when they stop being exact on large triangles
+		const int blockGroupMinX{ std::max(setup.minX, px / m_DepthBlockSize * m_DepthBlockSize) / Simd::LaneCount * Simd::LaneCount };
+
+		//Edge values at the first group of this row, the offsets are whole pixels so the result stays exact
+		const float rowOffsetY{ static_cast<float>(py - setup.minY) };
+		const float rowOffsetX{ static_cast<float>(blockGroupMinX - setup.groupMinX) };
+
+		const Simd::Float laneOffsets{ Simd::LaneOffsets() };
+
+		for (int edgeIdx{}; edgeIdx < 3; ++edgeIdx)
+		{
+			const Vector2& edge{ setup.edges[edgeIdx] };
+			const Simd::Float laneStep{ Simd::Mul(laneOffsets, Simd::Set(-edge.y)) };
+			const Simd::Float groupStep{ Simd::Set(-edge.y * Simd::LaneCount) };
+
+			edgeFunctions[edgeIdx] = Simd::Add(Simd::Set(setup.startEdges[edgeIdx] + rowOffsetY * edge.x - rowOffsetX * edge.y), laneStep);
+
+			for (int groupX{ blockGroupMinX }; groupX < px; groupX += Simd::LaneCount)
+			{
+				edgeFunctions[edgeIdx] = Simd::Add(edgeFunctions[edgeIdx], groupStep);
+			}
+		}
+	}
+
+	template<RenderStateKey Key>
+	void SoftwareRasterizer::ShadePixels(const TriangleSetup& setup, int px, int py, Simd::Float weightV0, Simd::Float weightV1, Simd::Float weightV2,
+		Simd::Float interpolatedZDepth, int laneMask, const SoftwareMesh& mesh) const
+	{
+		//Interpolated attributes of the group, one array per scalar component
+		alignas(32) float attributes[m_NumAttributes][Simd::LaneCount];
+		alignas(32) float depths[Simd::LaneCount];
+		alignas(32) float wDepths[Simd::LaneCount];
+		//du/dx, dv/dx, du/dy and dv/dy of the group
+		alignas(32) float uvDerivatives[4][Simd::LaneCount];
+
+		Simd::Store(depths, interpolatedZDepth);
+
+		if constexpr (!Key.renderDepth)
+		{
+			const Simd::Float one{ Simd::Set(1.f) };
+			const Simd::Float inverseW0{ Simd::Set(setup.inverseW[0]) };
+			const Simd::Float inverseW1{ Simd::Set(setup.inverseW[1]) };
+			const Simd::Float inverseW2{ Simd::Set(setup.inverseW[2]) };
+
+			const Simd::Float interpolatedWDepth{ Simd::Div(one,
+				Simd::MulAdd(weightV0, inverseW0, Simd::MulAdd(weightV1, inverseW1, Simd::Mul(weightV2, inverseW2)))) };
+			Simd::Store(wDepths, interpolatedWDepth);
+
+			const Simd::Float perspectiveWeightV0{ Simd::Mul(Simd::Mul(weightV0, inverseW0), interpolatedWDepth) };
+			const Simd::Float perspectiveWeightV1{ Simd::Mul(Simd::Mul(weightV1, inverseW1), interpolatedWDepth) };
+			const Simd::Float perspectiveWeightV2{ Simd::Mul(Simd::Mul(weightV2, inverseW2), interpolatedWDepth) };
+
+			Simd::Float interpolated[m_NumAttributes];
+			for (int attributeIdx{}; attributeIdx < m_NumAttributes; ++attributeIdx)
+			{
+				interpolated[attributeIdx] =
+					Simd::MulAdd(perspectiveWeightV0, Simd::Set(setup.vertexAttributes[0][attributeIdx]),
+					Simd::MulAdd(perspectiveWeightV1, Simd::Set(setup.vertexAttributes[1][attributeIdx]),
+					Simd::Mul(perspectiveWeightV2, Simd::Set(setup.vertexAttributes[2][attributeIdx]))));
+			}
+
+			//Normalize the interpolated normal
+			const Simd::Float normalLength{ Simd::Sqrt(
+				Simd::MulAdd(interpolated[2], interpolated[2],
+				Simd::MulAdd(interpolated[3], interpolated[3],
+				Simd::Mul(interpolated[4], interpolated[4])))) };
+			for (int attributeIdx{ 2 }; attributeIdx < 5; ++attributeIdx)
+			{
+				interpolated[attributeIdx] = Simd::Div(interpolated[attributeIdx], normalLength);
+			}
+
+			for (int attributeIdx{}; attributeIdx < m_NumAttributes; ++attributeIdx)
+			{
+				Simd::Store(attributes[attributeIdx], interpolated[attributeIdx]);
+			}
+
+			const Simd::Float inverseWDerivativeXLanes{ Simd::Set(setup.inverseWDerivativeX) };
+			const Simd::Float inverseWDerivativeYLanes{ Simd::Set(setup.inverseWDerivativeY) };
+			const Simd::Float uvOverWDerivativeLanes[4]
+			{
+				Simd::Set(setup.uvOverWDerivativeX.x), Simd::Set(setup.uvOverWDerivativeX.y),
+				Simd::Set(setup.uvOverWDerivativeY.x), Simd::Set(setup.uvOverWDerivativeY.y)
+			};
+
+			for (int derivativeIdx{}; derivativeIdx < 4; ++derivativeIdx)
+			{
+				const Simd::Float inverseWDerivative{ derivativeIdx < 2 ? inverseWDerivativeXLanes : inverseWDerivativeYLanes };
+				const Simd::Float uvDerivative{ Simd::Mul(Simd::Sub(uvOverWDerivativeLanes[derivativeIdx],
+					Simd::Mul(interpolated[derivativeIdx % 2], inverseWDerivative)), interpolatedWDepth) };
+				Simd::Store(uvDerivatives[derivativeIdx], uvDerivative);
+			}
+		}
+
+		const int pixelIdx{ px + py * m_Stride };
+
+		constexpr bool hasSpecular{ !Key.renderDepth && (Key.shadingMode == ShadingMode::Specular || Key.shadingMode == ShadingMode::Combined) };
+
+		//Red, green and blue of every lane, unused lanes stay black
+		alignas(32) float channels[3][Simd::LaneCount]{};
+		//Specular red, green, blue, cosine and exponent of every lane, the power is raised for the whole group at once
+		alignas(32) float specularTerms[5][Simd::LaneCount]{};
+
+		for (int lane{}; lane < Simd::LaneCount; ++lane)
+		{
+			if ((laneMask & (1 << lane)) == 0) continue;
+
+			ColorRGB finalColor{};
+
+			if constexpr (!Key.renderDepth)
+			{
+				Pixel_Out pixelOut{ Vector4{float(px + lane), float(py), depths[lane], wDepths[lane]} };
+				pixelOut.uv = { attributes[0][lane], attributes[1][lane] };
+				pixelOut.uvDerivativeX = { uvDerivatives[0][lane], uvDerivatives[1][lane] };
+				pixelOut.uvDerivativeY = { uvDerivatives[2][lane], uvDerivatives[3][lane] };
+				pixelOut.normal = { attributes[2][lane], attributes[3][lane], attributes[4][lane] };
+				pixelOut.tangent = { attributes[5][lane], attributes[6][lane], attributes[7][lane] };
+				pixelOut.viewDirection = { attributes[8][lane], attributes[9][lane], attributes[10][lane] };
+
+				SpecularTerm specular{};
+				finalColor = PixelShading<Key>(pixelOut, mesh, specular);
+
+				if constexpr (hasSpecular)
+				{
+					specularTerms[0][lane] = specular.color.r;
+					specularTerms[1][lane] = specular.color.g;
+					specularTerms[2][lane] = specular.color.b;
+					specularTerms[3][lane] = specular.cosAngle;
+					specularTerms[4][lane] = specular.exponent;
+				}
+			}
+			else
+			{
+				const float depthColor{ Remap(depths[lane], 0.997f, 1.0f) };
+
+				finalColor = { depthColor, depthColor , depthColor };
+			}
+
+			channels[0][lane] = finalColor.r;
+			channels[1][lane] = finalColor.g;
+			channels[2][lane] = finalColor.b;
+		}
+
+		Simd::Float red{ Simd::Load(channels[0]) };
+		Simd::Float green{ Simd::Load(channels[1]) };
+		Simd::Float blue{ Simd::Load(channels[2]) };
+
+		if constexpr (hasSpecular)
+		{
+			const Simd::Float phongSpecular{ Simd::Pow(Simd::Load(specularTerms[3]), Simd::Load(specularTerms[4])) };
+
+			red = Simd::MulAdd(Simd::Load(specularTerms[0]), phongSpecular, red);
+			green = Simd::MulAdd(Simd::Load(specularTerms[1]), phongSpecular, green);
+			blue = Simd::MulAdd(Simd::Load(specularTerms[2]), phongSpecular, blue);
+		}
+
+		//Same as ColorRGB::MaxToOne, dividing by one leaves the lanes that don't overflow untouched
+		const Simd::Float one{ Simd::Set(1.f) };
+		const Simd::Float maxChannel{ Simd::Max(red, Simd::Max(green, blue)) };
+		const Simd::Float divisor{ Simd::Select(Simd::Less(one, maxChannel), maxChannel, one) };
+
+		//Update Color in Buffer, the whole group at once when every lane is covered
+		uint32_t* pPixels{ m_pColorBufferPixels + pixelIdx };
+		if (laneMask == (1 << Simd::LaneCount) - 1)
+		{
+			Simd::StoreXRGB(pPixels, Simd::Div(red, divisor), Simd::Div(green, divisor), Simd::Div(blue, divisor));
+			return;
+		}
+
+		alignas(32) uint32_t packedColors[Simd::LaneCount];
+		Simd::StoreXRGB(packedColors, Simd::Div(red, divisor), Simd::Div(green, divisor), Simd::Div(blue, divisor));
+
+		for (int lane{}; lane < Simd::LaneCount; ++lane)
+		{
+			if (laneMask & (1 << lane))
+				pPixels[lane] = packedColors[lane];
+		}
+	}
+
+	template<RenderStateKey Key>
+	void SoftwareRasterizer::ResolveTile(Tile& tile, const SoftwareMesh& mesh) const
+	{
+		const Simd::Float one{ Simd::Set(1.f) };
+
+		for (int py{ tile.minY }; py < tile.maxY; ++py)
+		{
+			for (int px{ tile.minX }; px < tile.maxX; px += Simd::LaneCount)
+			{
+				const uint32_t* pTriangleIdx{ m_pVisibilityBufferPixels + px + py * m_Stride };
+
+				int remainingMask{};
+				for (int lane{}; lane < Simd::LaneCount && px + lane < tile.maxX; ++lane)
+				{
+					if (pTriangleIdx[lane] != m_NoTriangle)
+						remainingMask |= 1 << lane;
+				}
+
+				//Lanes covered by the same triangle are shaded together, most groups lie inside a single triangle
+				while (remainingMask != 0)
+				{
+					const uint32_t triangleIdx{ pTriangleIdx[std::countr_zero(static_cast<uint32_t>(remainingMask))] };
+
+					int triangleMask{};
+					for (int lane{}; lane < Simd::LaneCount; ++lane)
+					{
+						if ((remainingMask & (1 << lane)) != 0 && pTriangleIdx[lane] == triangleIdx)
+							triangleMask |= 1 << lane;
+					}
+					remainingMask &= ~triangleMask;
+
+					const TriangleSetup& setup{ m_TriangleSetups[triangleIdx] };
+
+					//The barycentric weights are rebuilt from the edge functions, exactly as they were during rasterization
+					Simd::Float edgeFunctions[3];
+					CalculateEdgeFunctions(setup, px, py, edgeFunctions);
+
+					const Simd::Float inverseAreaLanes{ Simd::Set(setup.inverseTriangleArea) };
+					const Simd::Float weightV0{ Simd::Mul(edgeFunctions[1], inverseAreaLanes) };
+					const Simd::Float weightV1{ Simd::Mul(edgeFunctions[2], inverseAreaLanes) };
+					const Simd::Float weightV2{ Simd::Mul(edgeFunctions[0], inverseAreaLanes) };
+
+					const Simd::Float interpolatedZDepth{ Simd::Div(one,
+						Simd::MulAdd(weightV0, Simd::Set(setup.inverseZ[0]), Simd::MulAdd(weightV1, Simd::Set(setup.inverseZ[1]), Simd::Mul(weightV2, Simd::Set(setup.inverseZ[2]))))) };
+
+					ShadePixels<Key>(setup, px, py, weightV0, weightV1, weightV2, interpolatedZDepth, triangleMask, mesh);
+					tile.overdrawStats.pixelsShaded += std::popcount(static_cast<uint32_t>(triangleMask));
+				}
+			}
+		}
+	}
+
+	void SoftwareRasterizer::UpdateDepthBlock(int blockX, int blockY) const
+	{
+		const int minX{ blockX * m_DepthBlockSize };
+		const int minY{ blockY * m_DepthBlockSize };
+		const int maxX{ std::min(minX + m_DepthBlockSize, m_Width) };
+		const int maxY{ std::min(minY + m_DepthBlockSize, m_Height) };
+
+		float minDepth{ FLT_MAX };
+		float maxDepth{ 0.f };
+
+		for (int py{ minY }; py < maxY; ++py)
+		{
+			for (int px{ minX }; px < maxX; ++px)
+			{
+				const float depth{ m_pDepthBufferPixels[px + py * m_Stride] };
+				minDepth = std::min(minDepth, depth);
+				maxDepth = std::max(maxDepth, depth);
+			}
+		}
+
+		const int blockIdx{ blockX + blockY * m_NumDepthBlocksX };
+		m_pDepthBlockMin[blockIdx] = minDepth;
+		m_pDepthBlockMax[blockIdx] = maxDepth;
+	}
+
+	void SoftwareRasterizer::VertexTransformationFunction(SoftwareMesh& mesh, int firstVertex, int lastVertex) const
+	{
+		static_assert(SoftwareMesh::m_StreamAlignment % Simd::LaneCount == 0 && m_VertexBatchSize % SoftwareMesh::m_StreamAlignment == 0);
+
+		const VertexStreams& streams{ mesh.GetVertexStreams() };
+		auto& vertices_out{ mesh.GetVerticesOut() };
+
+		//Matrix rows broadcast over the lanes, row 3 holds the translation
+		Simd::Float worldViewProjection[4][4];
+		Simd::Float world[3][3];
+		for (int row{}; row < 4; ++row)
+		{
+			for (int column{}; column < 4; ++column)
+			{
+				worldViewProjection[row][column] = Simd::Set(m_WorldViewProjectionMatrix[row][column]);
+
+				if (row < 3 && column < 3)
+					world[row][column] = Simd::Set(m_WorldMatrix[row][column]);
+			}
+		}
+
+		const auto transformVector{ [](const Simd::Float(&matrix)[3][3], Simd::Float x, Simd::Float y, Simd::Float z, int column)
+			{
+				return Simd::MulAdd(matrix[0][column], x, Simd::MulAdd(matrix[1][column], y, Simd::Mul(matrix[2][column], z)));
+			} };
+
+		const auto inverseLength{ [](Simd::Float x, Simd::Float y, Simd::Float z)
+			{
+				return Simd::Div(Simd::Set(1.f), Simd::Sqrt(Simd::MulAdd(x, x, Simd::MulAdd(y, y, Simd::Mul(z, z)))));
+			} };
+
+		//Transformed components of the current group, stored per lane to fill in the output vertices
+		constexpr int numComponents{ 13 };
+		alignas(32) float components[numComponents][Simd::LaneCount];
+
+		//Streams are padded so the last group can always be loaded completely
+		for (int groupStart{ firstVertex }; groupStart < lastVertex; groupStart += Simd::LaneCount)
+		{
+			const Simd::Float positionX{ Simd::Load(streams.positionX.data() + groupStart) };
+			const Simd::Float positionY{ Simd::Load(streams.positionY.data() + groupStart) };
+			const Simd::Float positionZ{ Simd::Load(streams.positionZ.data() + groupStart) };
+
+			Simd::Float position[4];
+			for (int column{}; column < 4; ++column)
+			{
+				position[column] = Simd::MulAdd(worldViewProjection[0][column], positionX,
+					Simd::MulAdd(worldViewProjection[1][column], positionY,
+					Simd::MulAdd(worldViewProjection[2][column], positionZ, worldViewProjection[3][column])));
+			}
+
+			const Simd::Float normalX{ Simd::Load(streams.normalX.data() + groupStart) };
+			const Simd::Float normalY{ Simd::Load(streams.normalY.data() + groupStart) };
+			const Simd::Float normalZ{ Simd::Load(streams.normalZ.data() + groupStart) };
+
+			Simd::Float normal[3];
+			for (int column{}; column < 3; ++column)
+			{
+				normal[column] = transformVector(world, normalX, normalY, normalZ, column);
+			}
+
+			const Simd::Float tangentX{ Simd::Load(streams.tangentX.data() + groupStart) };
+			const Simd::Float tangentY{ Simd::Load(streams.tangentY.data() + groupStart) };
+			const Simd::Float tangentZ{ Simd::Load(streams.tangentZ.data() + groupStart) };
+
+			Simd::Float tangent[3];
+			for (int column{}; column < 3; ++column)
+			{
+				tangent[column] = transformVector(world, tangentX, tangentY, tangentZ, column);
+			}
+
+			const Simd::Float inverseNormalLength{ inverseLength(normal[0], normal[1], normal[2]) };
+			const Simd::Float inverseTangentLength{ inverseLength(tangent[0], tangent[1], tangent[2]) };
+			//The view direction is the direction from the camera to the vertex in clip space
+			const Simd::Float inverseViewLength{ inverseLength(position[0], position[1], position[2]) };
+
+			for (int column{}; column < 4; ++column)
+			{
+				Simd::Store(components[column], position[column]);
+			}
+			for (int column{}; column < 3; ++column)
+			{
+				Simd::Store(components[4 + column], Simd::Mul(normal[column], inverseNormalLength));
+				Simd::Store(components[7 + column], Simd::Mul(tangent[column], inverseTangentLength));
+				Simd::Store(components[10 + column], Simd::Mul(position[column], inverseViewLength));
+			}
+
+			const int groupSize{ std::min(Simd::LaneCount, lastVertex - groupStart) };
+			for (int lane{}; lane < groupSize; ++lane)
+			{
+				Vertex_Out& outVertex{ vertices_out[groupStart + lane] };
+
+				outVertex.position = { components[0][lane], components[1][lane], components[2][lane], components[3][lane] };
+				outVertex.uv = { streams.u[groupStart + lane], streams.v[groupStart + lane] };
+				outVertex.normal = { components[4][lane], components[5][lane], components[6][lane] };
+				outVertex.tangent = { components[7][lane], components[8][lane], components[9][lane] };
+				outVertex.viewDirection = { components[10][lane], components[11][lane], components[12][lane] };
+			}
+		}
+	}
+
+	template<RenderStateKey Key>
+	ColorRGB SoftwareRasterizer::PixelShading(Pixel_Out& pixel, const SoftwareMesh& mesh, SpecularTerm& specular) const
+	{
+		//Observed area without a normal map doesn't read any material map
+		MaterialSample material{};
+		if constexpr (Key.useNormalMap || Key.shadingMode != ShadingMode::ObservedArea)
+		{
+			material = mesh.SampleMaterial(pixel.uv, SamplerState{ m_FilterState, pixel.uvDerivativeX, pixel.uvDerivativeY });
+		}
+
+		Vector3 sampledNormal{ pixel.normal };
+		if constexpr (Key.useNormalMap)
+		{
+			const Vector3 binormal{ Vector3::Cross(pixel.normal, pixel.tangent) };
+			const Matrix tangentSpaceAxis{ pixel.tangent, binormal.Normalized(), pixel.normal, {0.f, 0.f, 0.f} };
+
+			sampledNormal = { material.normal.r, material.normal.g, material.normal.b };
+
+			sampledNormal = 2 * sampledNormal - Vector3{ 1.f, 1.f, 1.f };
+			sampledNormal = tangentSpaceAxis.TransformVector(sampledNormal);
+		}
+		sampledNormal.Normalize();
+
+		const float observedArea{ std::max(0.f, Vector3::Dot(sampledNormal, -m_LightDirection)) };
+		const float kd{ .5f };
+
+		if constexpr (Key.shadingMode == ShadingMode::ObservedArea)
+		{
+			return ColorRGB{ 1, 1, 1 } *observedArea;
+		}
+		else if constexpr (Key.shadingMode == ShadingMode::Diffuse)
+		{
+			ColorRGB diffuse{ (material.diffuse * kd) / PI * m_LightIntensity };
+			return diffuse * observedArea;
+		}
+		else if constexpr (Key.shadingMode == ShadingMode::Specular)
+		{
+			specular = CalculateSpecular(pixel, sampledNormal, material);
+			specular.color *= observedArea;
+
+			return ColorRGB{};
+		}
+		else
+		{
+			ColorRGB diffuse{ (material.diffuse * kd) / PI * m_LightIntensity };
+
+			specular = CalculateSpecular(pixel, sampledNormal, material);
+
+			return diffuse * observedArea;
+		}
+	}
+
+	SoftwareRasterizer::SpecularTerm SoftwareRasterizer::CalculateSpecular(const Pixel_Out& pixel, const Vector3& sampledNormal, const MaterialSample& material) const
+	{
+		const Vector3 reflect{ Vector3::Reflect(m_LightDirection, sampledNormal) };
+
+		const float cosAngle{ std::max(0.f, Vector3::Dot(reflect, -pixel.viewDirection)) };
+
+		const float exp{ material.gloss * m_Shininess };
+
+		//ShadePixels raises cosAngle to exp for the whole pixel group at once
+		return SpecularTerm{ material.specular, cosAngle, exp };
+	}
+
+	BoundingBox SoftwareRasterizer::GetBoundingBox(Vector2 v0, Vector2 v1, Vector2 v2) const
+	{
+		BoundingBox box{ m_Width, m_Height };
+
+		box.UpdateMin(v0);
+		box.UpdateMin(v1);
+		box.UpdateMin(v2);
+
+		box.UpdateMax(v0);
+		box.UpdateMax(v1);
+		box.UpdateMax(v2);
+
+		return box;
+	}
+}
@@ -0,0 +1,307 @@
+#pragma once
+#include "Simd.h"
+
+namespace dae
+{
+	class SoftwareMesh;
+	struct MaterialSample;
+	class ThreadPool;
+
+	//Every render state the pixel pipeline branches on. RenderMesh picks the pipeline instantiated for the current state once
+	//per draw, so the per pixel loops are compiled without state branches. Depth and bounding box visualization ignore the shading
+	struct RenderStateKey
+	{
+		ShadingMode shadingMode{ ShadingMode::Combined };
+		bool useNormalMap{ true };
+		bool renderDepth{ false };
+		bool renderBoundingBox{ false };
+		bool visibilityBuffer{ false };
+	};
+
+	//CPU rasterizer rendering into an in-memory framebuffer, has no dependency on DirectX or SDL
+	//so it can run headless. The color buffer is stored as XRGB8888 (0x00RRGGBB), rows are GetStride() pixels apart
+	//Pixels are rasterized in groups of Simd::LaneCount, rows are padded so a group never leaves its row
+	//Triangles are binned into screen tiles which are rasterized in parallel, every tile is owned by
+	//a single worker so the color and depth buffers need no locking
+	//The depth buffer keeps the min and max depth of every 8x8 block so occluded blocks and triangles are skipped early
+	//With the visibility buffer a tile first rasterizes only depth and the index of the triangle in front, then shades
+	//every covered pixel once. Each draw is resolved on its own, overdraw between meshes is still shaded
+	class SoftwareRasterizer final
+	{
+	public:
+		//numThreads includes the calling thread, 0 uses every hardware thread
+		SoftwareRasterizer(int width, int height, int numThreads = 0);
+		~SoftwareRasterizer();
+
+		SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+		SoftwareRasterizer(SoftwareRasterizer&&) noexcept = delete;
+		SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+		SoftwareRasterizer& operator=(SoftwareRasterizer&&) noexcept = delete;
+
+		void SetMatrices(const Matrix& worldViewProjection, const Matrix& worldMatrix);
+
+		void SetShadingMode(ShadingMode shadingMode) { m_ShadingMode = shadingMode; }
+		void SetUseNormalMap(bool useNormalMap) { m_UseNormalMap = useNormalMap; }
+		void SetRenderDepth(bool renderDepth) { m_RenderDepth = renderDepth; }
+		void SetRenderBoundingBox(bool renderBoundingBox) { m_RenderBoundingBox = renderBoundingBox; }
+		void SetCullMode(CullMode cullMode) { m_CullMode = cullMode; }
+		//Texture filtering of the material maps, matches the hardware sampler states
+		void SetFilterState(FilterState filterState) { m_FilterState = filterState; }
+		//Defers the shading of the shaded modes until the visible triangle of every pixel is known
+		void SetUseVisibilityBuffer(bool useVisibilityBuffer) { m_UseVisibilityBuffer = useVisibilityBuffer; }
+
+		//Clears the color buffer to the given color and the depth buffer to FLT_MAX
+		//The clear is lazy, every tile is cleared by the next RenderMesh when it draws into it. Tiles without triangles only get the
+		//clear color, and not even that when they still hold it. The getters below clear the tiles no draw touched
+		void ClearBuffers(const ColorRGB& clearColor);
+
+		//function that renders a single mesh
+		void RenderMesh(SoftwareMesh& mesh);
+
+		//Gives the tiles no draw touched since the last ClearBuffers the clear color first
+		uint32_t* GetColorBuffer();
+		//Clears the depth of the tiles no draw touched since the last ClearBuffers first
+		float* GetDepthBuffer();
+
+		int GetWidth() const { return m_Width; }
+		int GetHeight() const { return m_Height; }
+		int GetStride() const { return m_Stride; }
+
+		int GetNumThreads() const;
+
+		//Culling stage and hierarchical depth test counters since the last ClearBuffers
+		CullStats GetCullStats() const;
+		//Depth test and shading counters since the last ClearBuffers
+		OverdrawStats GetOverdrawStats() const;
+
+		static uint32_t PackColor(const ColorRGB& color);
+
+	private:
+		int m_Width{};
+		int m_Height{};
+		int m_Stride{};
+
+		uint32_t* m_pColorBufferPixels{};
+		float* m_pDepthBufferPixels{};
+		//Index in m_TileTriangles of the triangle in front of every pixel, only used by the visibility buffer
+		uint32_t* m_pVisibilityBufferPixels{};
+
+		static constexpr int m_DepthBlockSize{ 8 };
+		int m_NumDepthBlocksX{};
+		int m_NumDepthBlocksY{};
+		float* m_pDepthBlockMin{};
+		float* m_pDepthBlockMax{};
+
+		//Packed color of the last ClearBuffers
+		uint32_t m_ClearColor{};
+
+		static constexpr int m_TileSize{ 64 };
+		int m_NumTilesX{};
+		int m_NumTilesY{};
+		std::vector<Tile> m_Tiles{};
+
+		//Output of the primitive assembly of one batch of triangles, clipped triangles index the batch's own clipped vertices
+		//until BinTriangles gathers them into m_ClippedVertices
+		struct AssemblyBatch
+		{
+			std::vector<BinnedTriangle> binnedTriangles{};
+			std::vector<Vertex_Out> clippedVertices{};
+			std::vector<Vector2> clippedVertices_ScreenSpace{};
+
+			//Submitted and facing culled triangles of the batch
+			CullStats cullStats{};
+		};
+
+		//Scratch buffers of primitive assembly, they keep their capacity between frames so binning doesn't allocate
+		std::vector<AssemblyBatch> m_AssemblyBatches{};
+		//Culling stage counters of every draw since the last ClearBuffers
+		CullStats m_AssemblyCullStats{};
+		std::vector<uint32_t> m_TileTriangles{};
+
+		ThreadPool* m_pThreadPool{};
+
+		//Triangles crossing the near or far plane or leaving the guard band are clipped in homogeneous space,
+		//the guard band is in NDC units so only triangles reaching far outside the screen are clipped in x and y
+		static constexpr float m_GuardBand{ 4.f };
+		static constexpr float m_NearClipDepth{ 1e-6f };
+
+		static constexpr uint16_t m_ClipLeft{ 1 << 0 };
+		static constexpr uint16_t m_ClipRight{ 1 << 1 };
+		static constexpr uint16_t m_ClipBottom{ 1 << 2 };
+		static constexpr uint16_t m_ClipTop{ 1 << 3 };
+		static constexpr uint16_t m_ClipNear{ 1 << 4 };
+		static constexpr uint16_t m_ClipFar{ 1 << 5 };
+		static constexpr uint16_t m_ClipGuardLeft{ 1 << 6 };
+		static constexpr uint16_t m_ClipGuardRight{ 1 << 7 };
+		static constexpr uint16_t m_ClipGuardBottom{ 1 << 8 };
+		static constexpr uint16_t m_ClipGuardTop{ 1 << 9 };
+		static constexpr uint16_t m_ClipMask{ m_ClipNear | m_ClipFar | m_ClipGuardLeft | m_ClipGuardRight | m_ClipGuardBottom | m_ClipGuardTop };
+
+		//Binned triangle indices with this bit set refer to m_ClippedVertices instead of the index buffer
+		static constexpr uint32_t m_ClippedTriangleBit{ 0x80000000 };
+		//Binned triangles with this bit set have their winding swapped so they are rasterized clockwise
+		static constexpr uint32_t m_FlippedTriangleBit{ 0x40000000 };
+
+		//Visibility buffer value of pixels no triangle covers
+		static constexpr uint32_t m_NoTriangle{ 0xFFFFFFFF };
+
+		static constexpr uint8_t m_TriangleCulled{ 1 << 0 };
+		static constexpr uint8_t m_TriangleFlipped{ 1 << 1 };
+		static constexpr uint8_t m_TriangleNeedsClipping{ 1 << 2 };
+		//Set together with m_TriangleCulled when the cull mode rejected the triangle
+		static constexpr uint8_t m_TriangleFacingCulled{ 1 << 3 };
+
+		static constexpr int m_VertexBatchSize{ 1024 };
+		static constexpr int m_TriangleBatchSize{ 1024 };
+
+		//Vertices are snapped to 1/16th of a pixel before rasterization
+		static constexpr float m_SubpixelSteps{ 16.f };
+
+		std::vector<Vertex_Out> m_ClippedVertices{};
+		std::vector<Vector2> m_ClippedVertices_ScreenSpace{};
+
+		Matrix m_WorldViewProjectionMatrix{};
+		Matrix m_WorldMatrix{};
+
+		//Hash of everything the transformed vertices depend on, meshes transformed with the same key skip the transformation
+		uint64_t m_TransformKey{};
+
+		bool m_RenderBoundingBox{ false };
+		bool m_RenderDepth{ false };
+		bool m_UseNormalMap{ true };
+		bool m_UseVisibilityBuffer{ false };
+		ShadingMode m_ShadingMode{ ShadingMode::Combined };
+		CullMode m_CullMode{ CullMode::Back };
+		FilterState m_FilterState{ FilterState::Point };
+
+		const Vector3 m_LightDirection = Vector3{ .577f, -.577f, .577f }.Normalized();
+		float m_LightIntensity{ 7.f };
+		float m_Shininess{ 25.f };
+		ColorRGB m_Ambient{ .025f, .025f, .025f };
+
+		//function that returns the bounding box for a triangle
+		BoundingBox GetBoundingBox(Vector2 v0, Vector2 v1, Vector2 v2) const;
+
+		//function that calculates the clip codes and projected positions of a range of transformed vertices
+		void ClipAndProjectVertices(SoftwareMesh& mesh, int firstVertex, int lastVertex);
+
+		uint16_t CalculateClipCode(const Vector4& position) const;
+
+		//function that converts a position from NDC to screen space
+		Vector2 NdcToScreen(const Vector4& position) const;
+
+		//function that culls a range of triangles, only triangles that need clipping are left for after clipping
+		void CullTriangles(SoftwareMesh& mesh, int firstTriangle, int lastTriangle);
+
+		//function that returns whether a triangle is culled or has to be flipped to be rasterized, by its screen space winding and size
+		uint8_t CalculateCullFlags(const Vector2& screen0, const Vector2& screen1, const Vector2& screen2) const;
+
+		//FNV-1a hash of a block of memory, never returns 0 so it can be used as a TransformCache key
+		static uint64_t HashBytes(const void* pData, size_t size, uint64_t hash = 14695981039346656037ull);
+
+		static Vector2 SnapToSubpixel(const Vector2& position);
+
+		//function that clips a range of triangles and finds the tiles every visible one overlaps, writes only its own batch
+		void AssembleTriangles(SoftwareMesh& mesh, AssemblyBatch& batch, int firstTriangle, int lastTriangle) const;
+
+		//function that sorts the assembled triangles of every batch into the tiles they overlap, in submission order
+		void BinTriangles(int numBatches);
+
+		void BinTriangle(const BoundingBox& box, uint32_t triangleIdx, AssemblyBatch& batch) const;
+
+		//function that clips a triangle in clip space and adds the visible part to the clipped vertices of the batch as a triangle fan
+		void ClipTriangle(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, AssemblyBatch& batch) const;
+
+		using RenderTileFunction = void (SoftwareRasterizer::*)(Tile& tile, SoftwareMesh& mesh) const;
+
+		//function that returns the RenderTile instantiation of the current render state
+		RenderTileFunction SelectRenderTile() const;
+
+		template<ShadingMode TShadingMode>
+		RenderTileFunction SelectShadedRenderTile() const;
+
+		//function that renders every triangle binned into a tile, clipped to that tile
+		template<RenderStateKey Key>
+		void RenderTile(Tile& tile, SoftwareMesh& mesh) const;
+
+		//Uv, normal, tangent and view direction, interpolated per pixel
+		static constexpr int m_NumAttributes{ 11 };
+
+		//Constants of a triangle used by the rasterization and the attribute interpolation, clipped to a tile
+		struct TriangleSetup
+		{
+			int minX{};
+			int minY{};
+			int maxX{};
+			int maxY{};
+			int groupMinX{};
+
+			//Edges V0V1, V1V2 and V2V0 of the snapped triangle, their edge functions at the first group and the top-left fill bias
+			Vector2 edges[3]{};
+			float startEdges[3]{};
+			float biases[3]{};
+			float inverseTriangleArea{};
+
+			float inverseZ[3]{};
+			float inverseW[3]{};
+
+			float inverseWDerivativeX{};
+			float inverseWDerivativeY{};
+			Vector2 uvOverWDerivativeX{};
+			Vector2 uvOverWDerivativeY{};
+
+			float vertexAttributes[3][m_NumAttributes]{};
+		};
+
+		//Phong specular term of a pixel before the power, ShadePixels raises the cosines of a whole group with one Simd::Pow
+		struct SpecularTerm
+		{
+			ColorRGB color{};
+			float cosAngle{};
+			float exponent{};
+		};
+
+		//Setup of every entry of m_TileTriangles, only filled with the visibility buffer. Every tile writes its own range
+		mutable std::vector<TriangleSetup> m_TriangleSetups{};
+
+		//function that renders the part of a single triangle that lies inside the tile, tileTriangleIdx is its index in m_TileTriangles
+		template<RenderStateKey Key>
+		void RenderTriangle(const Triangle& triangle, int tileTriangleIdx, const SoftwareMesh& mesh, Tile& tile) const;
+
+		//function that fills the setup of the part of a triangle inside the tile, returns false when nothing of it is rasterized
+		bool SetupTriangle(const Triangle& triangle, const Tile& tile, TriangleSetup& setup) const;
+
+		//function that returns the edge functions V0V1, V1V2 and V2V0 of the pixel group starting at px, py
+		void CalculateEdgeFunctions(const TriangleSetup& setup, int px, int py, Simd::Float(&edgeFunctions)[3]) const;
+
+		//function that interpolates the attributes of a group of pixels and shades the lanes in laneMask
+		template<RenderStateKey Key>
+		void ShadePixels(const TriangleSetup& setup, int px, int py, Simd::Float weightV0, Simd::Float weightV1, Simd::Float weightV2,
+			Simd::Float interpolatedZDepth, int laneMask, const SoftwareMesh& mesh) const;
+
+		//function that shades every pixel of the tile covered in the visibility buffer
+		template<RenderStateKey Key>
+		void ResolveTile(Tile& tile, const SoftwareMesh& mesh) const;
+
+		//function that clears the depth of a tile and its depth blocks, and its color unless it still holds the clear color
+		void ClearTile(Tile& tile) const;
+
+		//function that fills the color of a tile with the clear color
+		void ClearTileColor(Tile& tile) const;
+
+		//function that recalculates the min and max depth of a block after it was written to
+		void UpdateDepthBlock(int blockX, int blockY) const;
+
+		//function to setup current triangle
+		bool CalculateTriangle(Triangle& triangle, SoftwareMesh& mesh, uint32_t startIdx) const;
+
+		//Function that transforms a range of vertices from the mesh from World space to clip space, Simd::LaneCount at a time
+		void VertexTransformationFunction(SoftwareMesh& mesh, int firstVertex, int lastVertex) const;
+
+		//Function that shades a single pixel, returns everything but the specular term which is left in specular
+		template<RenderStateKey Key>
+		ColorRGB PixelShading(Pixel_Out& pixel, const SoftwareMesh& mesh, SpecularTerm& specular) const;
+
+		SpecularTerm CalculateSpecular(const Pixel_Out& pixel, const Vector3& sampeledNormal, const MaterialSample& material) const;
+	};
+}
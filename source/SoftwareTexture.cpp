@@ -0,0 +1,462 @@
+#include "pch.h"
+#include "SoftwareTexture.h"
+
+namespace dae
+{
+	namespace
+	{
+		constexpr std::array<float, 256> CreateByteToFloatTable()
+		{
+			std::array<float, 256> table{};
+			for (int i{}; i < 256; ++i)
+			{
+				table[i] = i / 255.0f;
+			}
+			return table;
+		}
+
+		//Channel value of every byte, a lookup replaces a conversion and a division per channel
+		constexpr std::array<float, 256> g_ByteToFloat{ CreateByteToFloatTable() };
+
+		//texels are stored in RGBA8 byte order, the table maps every channel to the [0, 1] range
+		ColorRGB DecodeRGB(uint32_t pixel)
+		{
+			return ColorRGB
+			{
+				g_ByteToFloat[pixel & 0xFF],
+				g_ByteToFloat[(pixel >> 8) & 0xFF],
+				g_ByteToFloat[(pixel >> 16) & 0xFF]
+			};
+		}
+
+		//Filtered texels hold every channel in the [0, 255] range
+		ColorRGB DecodeRGB(Simd::Texel texel, float& alpha)
+		{
+			constexpr float scale{ 1.f / 255.f };
+
+			alignas(16) float channels[4];
+			Simd::StoreTexel(channels, texel);
+
+			alpha = channels[3] * scale;
+			return ColorRGB{ channels[0] * scale, channels[1] * scale, channels[2] * scale };
+		}
+
+		//The bits of a positive float read as an integer are a piecewise linear log2 scaled by 2^23 and offset by 127,
+		//exact at powers of two which is close enough to pick and blend levels
+		float FastLog2(float value)
+		{
+			return static_cast<float>(std::bit_cast<uint32_t>(value)) * (1.f / (1 << 23)) - 127.f;
+		}
+
+		//Wrap addressing, returns the fraction of a texture coordinate in [0, 1]
+		float Wrap(float coordinate)
+		{
+			const float wrapped{ coordinate - static_cast<float>(static_cast<int>(coordinate)) };
+			return wrapped < 0.f ? wrapped + 1.f : wrapped;
+		}
+
+		//Wrap addressing for point lookups, coordinates already in [0, 1] are kept so 1 still maps to the last texel
+		float WrapPoint(float coordinate)
+		{
+			return coordinate >= 0.f && coordinate <= 1.f ? coordinate : Wrap(coordinate);
+		}
+	}
+
+	SoftwareTexture::SoftwareTexture(int width, int height, const uint32_t* pPixels, TextureLayout layout)
+		:SoftwareTexture{ std::vector<MipLevel>{ MipLevel{ width, height, std::vector<uint32_t>(pPixels, pPixels + static_cast<size_t>(width) * height) } }, layout }
+	{
+	}
+
+	SoftwareTexture::SoftwareTexture(const std::vector<MipLevel>& mipChain, TextureLayout layout)
+	{
+		const std::vector<MipLevel>* mipChains[]{ &mipChain };
+		Initialize(mipChains, layout);
+	}
+
+	SoftwareTexture::SoftwareTexture(const std::vector<MipLevel>& mipChain, const std::vector<MipLevel>& secondMipChain, TextureLayout layout)
+		:m_TexelWords{ 2 }
+	{
+		const std::vector<MipLevel>* mipChains[]{ &mipChain, &secondMipChain };
+		Initialize(mipChains, layout);
+	}
+
+	void SoftwareTexture::Initialize(const std::vector<MipLevel>* const* ppMipChains, TextureLayout layout)
+	{
+		const std::vector<MipLevel>& mipChain{ *ppMipChains[0] };
+
+		m_Width = mipChain[0].width;
+		m_Height = mipChain[0].height;
+		m_WidthF = static_cast<float>(m_Width);
+		m_HeightF = static_cast<float>(m_Height);
+
+		const auto isPowerOfTwo{ [](int value) { return value > 0 && (value & (value - 1)) == 0; } };
+		if (layout == TextureLayout::Morton && !(isPowerOfTwo(m_Width) && isPowerOfTwo(m_Height)))
+		{
+			layout = TextureLayout::Tiled;
+		}
+		m_Layout = layout;
+
+		size_t numWords{};
+		m_Levels.resize(mipChain.size());
+		for (size_t levelIdx{}; levelIdx < mipChain.size(); ++levelIdx)
+		{
+			Level& level{ m_Levels[levelIdx] };
+			level.width = mipChain[levelIdx].width;
+			level.height = mipChain[levelIdx].height;
+			level.widthF = static_cast<float>(level.width);
+			level.heightF = static_cast<float>(level.height);
+			level.firstWord = numWords;
+
+			numWords += InitializeLevel(level) * m_TexelWords;
+		}
+
+		m_Pixels.resize(numWords);
+
+		for (size_t levelIdx{}; levelIdx < m_Levels.size(); ++levelIdx)
+		{
+			const Level& level{ m_Levels[levelIdx] };
+			for (int y{}; y < level.height; ++y)
+			{
+				for (int x{}; x < level.width; ++x)
+				{
+					const size_t offset{ level.firstWord + (level.offsetX[x] + level.offsetY[y]) * static_cast<size_t>(m_TexelWords) };
+
+					for (int word{}; word < m_TexelWords; ++word)
+					{
+						m_Pixels[offset + word] = (*ppMipChains[word])[levelIdx].pixels[x + static_cast<size_t>(y) * level.width];
+					}
+				}
+			}
+		}
+	}
+
+	size_t SoftwareTexture::InitializeLevel(Level& level) const
+	{
+		const int width{ level.width };
+		const int height{ level.height };
+
+		level.offsetX.resize(width);
+		level.offsetY.resize(height);
+
+		size_t numTexels{ static_cast<size_t>(width) * height };
+
+		switch (m_Layout)
+		{
+		case TextureLayout::Linear:
+			for (int x{}; x < width; ++x) level.offsetX[x] = x;
+			for (int y{}; y < height; ++y) level.offsetY[y] = y * width;
+			break;
+		case TextureLayout::Tiled:
+		{
+			//The last blocks of a row or column are padded
+			constexpr int blockSize{ 4 };
+			const int numBlocksX{ (width + blockSize - 1) / blockSize };
+			const int numBlocksY{ (height + blockSize - 1) / blockSize };
+
+			for (int x{}; x < width; ++x) level.offsetX[x] = (x / blockSize) * blockSize * blockSize + x % blockSize;
+			for (int y{}; y < height; ++y) level.offsetY[y] = (y / blockSize) * numBlocksX * blockSize * blockSize + (y % blockSize) * blockSize;
+
+			numTexels = static_cast<size_t>(numBlocksX) * numBlocksY * blockSize * blockSize;
+		}
+		break;
+		case TextureLayout::Morton:
+		{
+			//The bits of x and y alternate up to the size of the smaller side, the remaining bits of the larger side go on top
+			int numSharedBits{};
+			while ((2 << numSharedBits) <= std::min(width, height)) ++numSharedBits;
+
+			const auto spreadBits{ [numSharedBits](uint32_t value, int shift)
+				{
+					uint32_t result{};
+					for (int bit{}; bit < numSharedBits; ++bit)
+					{
+						result |= ((value >> bit) & 1) << (2 * bit + shift);
+					}
+					return result | (value >> numSharedBits) << (2 * numSharedBits);
+				} };
+
+			for (int x{}; x < width; ++x) level.offsetX[x] = spreadBits(x, 0);
+			for (int y{}; y < height; ++y) level.offsetY[y] = spreadBits(y, 1);
+		}
+		break;
+		}
+
+		return numTexels;
+	}
+
+	std::vector<MipLevel> SoftwareTexture::CreateMipChain(int width, int height, const uint32_t* pPixels)
+	{
+		std::vector<MipLevel> mipChain{};
+		mipChain.push_back(MipLevel{ width, height, std::vector<uint32_t>(pPixels, pPixels + static_cast<size_t>(width) * height) });
+
+		while (width > 1 || height > 1)
+		{
+			//An odd last row or column is clamped to, so it is averaged with itself
+			const int sourceWidth{ width };
+			const int sourceHeight{ height };
+			width = std::max(width / 2, 1);
+			height = std::max(height / 2, 1);
+
+			MipLevel level{ width, height, std::vector<uint32_t>(static_cast<size_t>(width) * height) };
+			const std::vector<uint32_t>& source{ mipChain.back().pixels };
+
+			for (int y{}; y < height; ++y)
+			{
+				const size_t row0{ static_cast<size_t>(std::min(2 * y, sourceHeight - 1)) * sourceWidth };
+				const size_t row1{ static_cast<size_t>(std::min(2 * y + 1, sourceHeight - 1)) * sourceWidth };
+
+				for (int x{}; x < width; ++x)
+				{
+					const int x0{ std::min(2 * x, sourceWidth - 1) };
+					const int x1{ std::min(2 * x + 1, sourceWidth - 1) };
+					const uint32_t texels[]{ source[row0 + x0], source[row0 + x1], source[row1 + x0], source[row1 + x1] };
+
+					uint32_t pixel{};
+					for (int shift{}; shift < 32; shift += 8)
+					{
+						uint32_t sum{ 2 };
+						for (const uint32_t texel : texels)
+						{
+							sum += (texel >> shift) & 0xFF;
+						}
+						pixel |= (sum / 4) << shift;
+					}
+					level.pixels[x + static_cast<size_t>(y) * width] = pixel;
+				}
+			}
+
+			mipChain.push_back(std::move(level));
+		}
+
+		return mipChain;
+	}
+
+	std::vector<MipLevel> SoftwareTexture::GetMipChain(int word) const
+	{
+		std::vector<MipLevel> mipChain(m_Levels.size());
+
+		for (size_t levelIdx{}; levelIdx < m_Levels.size(); ++levelIdx)
+		{
+			const Level& level{ m_Levels[levelIdx] };
+			MipLevel& mipLevel{ mipChain[levelIdx] };
+			mipLevel.width = level.width;
+			mipLevel.height = level.height;
+			mipLevel.pixels.resize(static_cast<size_t>(level.width) * level.height);
+
+			for (int y{}; y < level.height; ++y)
+			{
+				for (int x{}; x < level.width; ++x)
+				{
+					mipLevel.pixels[x + static_cast<size_t>(y) * level.width] = GetTexel(level, x, y, word);
+				}
+			}
+		}
+
+		return mipChain;
+	}
+
+	float SoftwareTexture::CalculateLod(const Vector2& uvDerivativeX, const Vector2& uvDerivativeY) const
+	{
+		//Squared length in texels of the larger of both derivatives, halved in log space because it is squared
+		const float texelsX{ Square(uvDerivativeX.x * m_WidthF) + Square(uvDerivativeX.y * m_HeightF) };
+		const float texelsY{ Square(uvDerivativeY.x * m_WidthF) + Square(uvDerivativeY.y * m_HeightF) };
+
+		return .5f * FastLog2(std::max(texelsX, texelsY));
+	}
+
+	size_t SoftwareTexture::GetTexelOffset(const Vector2& uv, float lod) const
+	{
+		const int levelIdx{ std::clamp(static_cast<int>(lod + .5f), 0, static_cast<int>(m_Levels.size()) - 1) };
+		const Level& level{ m_Levels[levelIdx] };
+
+		//calculate the x and y coordinates on the uv map, uv == 1 maps to the last texel
+		const int x{ std::min(static_cast<int>(WrapPoint(uv.x) * level.widthF), level.width - 1) };
+		const int y{ std::min(static_cast<int>(WrapPoint(uv.y) * level.heightF), level.height - 1) };
+
+		return level.firstWord + static_cast<size_t>(level.offsetX[x] + level.offsetY[y]) * m_TexelWords;
+	}
+
+	void SoftwareTexture::SampleFiltered(const Vector2& uv, const SamplerState& sampler, Simd::Texel* pTexel) const
+	{
+		for (int word{}; word < m_TexelWords; ++word)
+		{
+			pTexel[word] = Simd::TexelZero();
+		}
+
+		if (sampler.filter != FilterState::Anisotropic)
+		{
+			AddTrilinear(uv, CalculateLod(sampler.uvDerivativeX, sampler.uvDerivativeY), 1.f, pTexel);
+			return;
+		}
+
+		//The footprint of a pixel is an ellipse, probes spaced along its major axis each cover a part the size of the minor axis
+		const float texelsX{ Square(sampler.uvDerivativeX.x * m_WidthF) + Square(sampler.uvDerivativeX.y * m_HeightF) };
+		const float texelsY{ Square(sampler.uvDerivativeY.x * m_WidthF) + Square(sampler.uvDerivativeY.y * m_HeightF) };
+
+		const bool isMajorX{ texelsX >= texelsY };
+		const float majorLength{ sqrtf(isMajorX ? texelsX : texelsY) };
+		const float minorLength{ sqrtf(isMajorX ? texelsY : texelsX) };
+		const Vector2& majorAxis{ isMajorX ? sampler.uvDerivativeX : sampler.uvDerivativeY };
+
+		int numProbes{ 1 };
+		if (majorLength > 1.f)
+		{
+			numProbes = static_cast<int>(std::min(ceilf(majorLength / std::max(minorLength, 1.f)), static_cast<float>(m_MaxAnisotropy)));
+		}
+
+		const float lod{ FastLog2(majorLength / numProbes) };
+		const float weight{ 1.f / numProbes };
+
+		for (int probe{}; probe < numProbes; ++probe)
+		{
+			AddTrilinear(uv + majorAxis * ((probe + .5f) * weight - .5f), lod, weight, pTexel);
+		}
+	}
+
+	void SoftwareTexture::AddTrilinear(const Vector2& uv, float lod, float weight, Simd::Texel* pTexel) const
+	{
+		const int lastLevelIdx{ static_cast<int>(m_Levels.size()) - 1 };
+
+		if (lod <= 0.f || lastLevelIdx == 0)
+		{
+			AddBilinear(uv, m_Levels[0], weight, pTexel);
+			return;
+		}
+		if (lod >= lastLevelIdx)
+		{
+			AddBilinear(uv, m_Levels[lastLevelIdx], weight, pTexel);
+			return;
+		}
+
+		const int levelIdx{ static_cast<int>(lod) };
+		const float blend{ lod - levelIdx };
+
+		AddBilinear(uv, m_Levels[levelIdx], weight * (1.f - blend), pTexel);
+		AddBilinear(uv, m_Levels[levelIdx + 1], weight * blend, pTexel);
+	}
+
+	void SoftwareTexture::AddBilinear(const Vector2& uv, const Level& level, float weight, Simd::Texel* pTexel) const
+	{
+		//Texel centers are at half coordinates, the 2x2 texels around uv wrap around the edges
+		const float texelX{ Wrap(uv.x) * level.widthF - .5f };
+		const float texelY{ Wrap(uv.y) * level.heightF - .5f };
+
+		//Truncation floors here, the coordinates are at least -0.5
+		const int floorX{ static_cast<int>(texelX + 1.f) - 1 };
+		const int floorY{ static_cast<int>(texelY + 1.f) - 1 };
+		const float fractionX{ texelX - floorX };
+		const float fractionY{ texelY - floorY };
+
+		const uint32_t column0{ level.offsetX[floorX < 0 ? level.width - 1 : floorX] };
+		const uint32_t column1{ level.offsetX[floorX + 1 >= level.width ? 0 : floorX + 1] };
+		const uint32_t row0{ level.offsetY[floorY < 0 ? level.height - 1 : floorY] };
+		const uint32_t row1{ level.offsetY[floorY + 1 >= level.height ? 0 : floorY + 1] };
+
+		const size_t offsets[4]
+		{
+			level.firstWord + static_cast<size_t>(column0 + row0) * m_TexelWords,
+			level.firstWord + static_cast<size_t>(column1 + row0) * m_TexelWords,
+			level.firstWord + static_cast<size_t>(column0 + row1) * m_TexelWords,
+			level.firstWord + static_cast<size_t>(column1 + row1) * m_TexelWords
+		};
+		const float weights[4]
+		{
+			weight * (1.f - fractionX) * (1.f - fractionY),
+			weight * fractionX * (1.f - fractionY),
+			weight * (1.f - fractionX) * fractionY,
+			weight * fractionX * fractionY
+		};
+
+		for (int word{}; word < m_TexelWords; ++word)
+		{
+			Simd::Texel sum{ pTexel[word] };
+			for (int texelIdx{}; texelIdx < 4; ++texelIdx)
+			{
+				sum = Simd::TexelMulAdd(Simd::UnpackTexel(m_Pixels[offsets[texelIdx] + word]), weights[texelIdx], sum);
+			}
+			pTexel[word] = sum;
+		}
+	}
+
+	ColorRGB SoftwareTexture::Sample(const Vector2& uv, const SamplerState& sampler) const
+	{
+		if (sampler.filter == FilterState::Point)
+			return DecodeRGB(m_Pixels[GetTexelOffset(uv, CalculateLod(sampler.uvDerivativeX, sampler.uvDerivativeY))]);
+
+		Simd::Texel texels[2];
+		SampleFiltered(uv, sampler, texels);
+
+		float alpha{};
+		return DecodeRGB(texels[0], alpha);
+	}
+
+	ColorRGB SoftwareTexture::Sample(const Vector2& uv, const SamplerState& sampler, float& alpha) const
+	{
+		if (sampler.filter == FilterState::Point)
+		{
+			const uint32_t pixel{ m_Pixels[GetTexelOffset(uv, CalculateLod(sampler.uvDerivativeX, sampler.uvDerivativeY))] };
+
+			alpha = g_ByteToFloat[pixel >> 24];
+			return DecodeRGB(pixel);
+		}
+
+		Simd::Texel texels[2];
+		SampleFiltered(uv, sampler, texels);
+
+		return DecodeRGB(texels[0], alpha);
+	}
+
+	void SoftwareTexture::Sample(const Vector2& uv, const SamplerState& sampler, ColorRGB& first, ColorRGB& second) const
+	{
+		if (sampler.filter == FilterState::Point)
+		{
+			const size_t offset{ GetTexelOffset(uv, CalculateLod(sampler.uvDerivativeX, sampler.uvDerivativeY)) };
+
+			first = DecodeRGB(m_Pixels[offset]);
+			second = DecodeRGB(m_Pixels[offset + 1]);
+			return;
+		}
+
+		Simd::Texel texels[2];
+		SampleFiltered(uv, sampler, texels);
+
+		float alpha{};
+		first = DecodeRGB(texels[0], alpha);
+		second = DecodeRGB(texels[1], alpha);
+	}
+
+	bool SoftwareTexture::CanPack(const SoftwareTexture* pFirst, const SoftwareTexture* pSecond)
+	{
+		return pFirst && pSecond && !pFirst->IsInterleaved() && !pSecond->IsInterleaved()
+			&& pFirst->m_Width == pSecond->m_Width && pFirst->m_Height == pSecond->m_Height
+			&& pFirst->m_Levels.size() == pSecond->m_Levels.size();
+	}
+
+	SoftwareTexture* SoftwareTexture::PackWithAlpha(const SoftwareTexture* pRGB, const SoftwareTexture* pAlpha)
+	{
+		if (!CanPack(pRGB, pAlpha))
+			return nullptr;
+
+		std::vector<MipLevel> mipChain{ pRGB->GetMipChain(0) };
+		const std::vector<MipLevel> alphaMipChain{ pAlpha->GetMipChain(0) };
+		for (size_t levelIdx{}; levelIdx < mipChain.size(); ++levelIdx)
+		{
+			std::vector<uint32_t>& pixels{ mipChain[levelIdx].pixels };
+			const std::vector<uint32_t>& alphaPixels{ alphaMipChain[levelIdx].pixels };
+			for (size_t texelIdx{}; texelIdx < pixels.size(); ++texelIdx)
+			{
+				pixels[texelIdx] = (pixels[texelIdx] & 0x00FFFFFF) | (alphaPixels[texelIdx] & 0xFF) << 24;
+			}
+		}
+
+		return new SoftwareTexture{ mipChain, pRGB->m_Layout };
+	}
+
+	SoftwareTexture* SoftwareTexture::Interleave(const SoftwareTexture* pFirst, const SoftwareTexture* pSecond)
+	{
+		if (!CanPack(pFirst, pSecond))
+			return nullptr;
+
+		return new SoftwareTexture{ pFirst->GetMipChain(0), pSecond->GetMipChain(0), pFirst->m_Layout };
+	}
+}
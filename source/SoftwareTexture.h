@@ -0,0 +1,139 @@
+#pragma once
+#include "Simd.h"
+
+namespace dae
+{
+	//Order of the texels in memory, every layout is sampled the same way
+	enum class TextureLayout
+	{
+		//Row after row
+		Linear,
+		//4x4 blocks of texels stored together, a block of RGBA8 texels fills one 64 byte cache line
+		Tiled,
+		//Z-order curve, nearby texels are nearby in memory at every scale. Only for power of two sizes, others use Tiled
+		Morton
+	};
+
+	//One level of a mip chain, width * height tightly packed texels in RGBA8 byte order (SDL_PIXELFORMAT_RGBA32)
+	struct MipLevel
+	{
+		int width{};
+		int height{};
+		std::vector<uint32_t> pixels{};
+	};
+
+	//How a texture is sampled at a pixel, the same filters as the hardware sampler states. Addressing always wraps
+	//Zero derivatives sample the full size level
+	struct SamplerState
+	{
+		FilterState filter{ FilterState::Point };
+
+		//Change of the uv per pixel along the screen's x and y axis
+		Vector2 uvDerivativeX{};
+		Vector2 uvDerivativeY{};
+	};
+
+	//CPU side copy of a texture used by the software rasterizer, has no dependency on DirectX or SDL
+	//A texel is one RGBA8 word, or two when two images are interleaved so both are read with a single fetch
+	//Every mip level is stored in the same layout, one after the other in a single allocation
+	class SoftwareTexture final
+	{
+	public:
+		//pPixels holds width * height tightly packed texels in RGBA8 byte order (SDL_PIXELFORMAT_RGBA32), the texture has no mips
+		SoftwareTexture(int width, int height, const uint32_t* pPixels, TextureLayout layout = TextureLayout::Linear);
+		explicit SoftwareTexture(const std::vector<MipLevel>& mipChain, TextureLayout layout = TextureLayout::Linear);
+		//Interleaves two mip chains of the same size, texel i of a level holds the first chain's texel i followed by the second's
+		SoftwareTexture(const std::vector<MipLevel>& mipChain, const std::vector<MipLevel>& secondMipChain, TextureLayout layout = TextureLayout::Linear);
+
+		~SoftwareTexture() = default;
+
+		SoftwareTexture& operator=(SoftwareTexture& rhs) = delete;
+		SoftwareTexture& operator=(SoftwareTexture&& rhs) = delete;
+		SoftwareTexture(SoftwareTexture& rhs) = delete;
+		SoftwareTexture(SoftwareTexture&& rhs) = delete;
+
+		//Point sampling reads the nearest texel of the nearest mip level, linear filtering blends the 2x2 nearest texels
+		//of the two nearest levels and anisotropic filtering averages up to m_MaxAnisotropy linear samples along the footprint
+		//Returns the rgb of the first image
+		ColorRGB Sample(const Vector2& uv, const SamplerState& sampler = {}) const;
+		//Returns the rgb and alpha of the first image
+		ColorRGB Sample(const Vector2& uv, const SamplerState& sampler, float& alpha) const;
+		//Returns the rgb of both interleaved images
+		void Sample(const Vector2& uv, const SamplerState& sampler, ColorRGB& first, ColorRGB& second) const;
+
+		int GetWidth() const { return m_Width; }
+		int GetHeight() const { return m_Height; }
+		int GetNumLevels() const { return static_cast<int>(m_Levels.size()); }
+		bool IsInterleaved() const { return m_TexelWords == 2; }
+		TextureLayout GetLayout() const { return m_Layout; }
+
+		//Returns a texture with the rgb of pRGB and the red channel of pAlpha as alpha, nullptr when they can't be packed
+		static SoftwareTexture* PackWithAlpha(const SoftwareTexture* pRGB, const SoftwareTexture* pAlpha);
+		//Returns a texture interleaving pFirst and pSecond, nullptr when they can't be packed
+		static SoftwareTexture* Interleave(const SoftwareTexture* pFirst, const SoftwareTexture* pSecond);
+
+		//Returns the full mip chain of an image down to 1x1, every level is a 2x2 box filter of the previous one
+		static std::vector<MipLevel> CreateMipChain(int width, int height, const uint32_t* pPixels);
+
+	private:
+		struct Level
+		{
+			int width{};
+			int height{};
+			float widthF{};
+			float heightF{};
+
+			//Index of the first word of the level in m_Pixels
+			size_t firstWord{};
+
+			//The texel at (x, y) is at offsetX[x] + offsetY[y], every layout splits into a column and a row part
+			std::vector<uint32_t> offsetX{};
+			std::vector<uint32_t> offsetY{};
+		};
+
+		//Same limit as the hardware anisotropic sampler
+		static constexpr int m_MaxAnisotropy{ 16 };
+
+		int m_Width{};
+		int m_Height{};
+		float m_WidthF{};
+		float m_HeightF{};
+		int m_TexelWords{ 1 };
+		TextureLayout m_Layout{ TextureLayout::Linear };
+
+		std::vector<Level> m_Levels{};
+		std::vector<uint32_t> m_Pixels{};
+
+		//function that lays out every level and copies the texels of m_TexelWords mip chains into it
+		void Initialize(const std::vector<MipLevel>* const* ppMipChains, TextureLayout layout);
+
+		//function that fills the offset tables of a level and returns its number of texels, padding included
+		size_t InitializeLevel(Level& level) const;
+
+		//function that returns the level of detail from the uv derivatives, log2 of the texels a pixel covers
+		float CalculateLod(const Vector2& uvDerivativeX, const Vector2& uvDerivativeY) const;
+
+		//function that returns the index of the first word of the texel at uv in the level nearest to lod
+		size_t GetTexelOffset(const Vector2& uv, float lod) const;
+
+		//function that returns every word of the filtered texel at uv, channels in the [0, 255] range
+		void SampleFiltered(const Vector2& uv, const SamplerState& sampler, Simd::Texel* pTexel) const;
+
+		//function that adds the trilinear sample at uv of the level of detail lod to pTexel, scaled by weight
+		void AddTrilinear(const Vector2& uv, float lod, float weight, Simd::Texel* pTexel) const;
+
+		//function that adds the bilinear sample at uv of a level to pTexel, scaled by weight
+		void AddBilinear(const Vector2& uv, const Level& level, float weight, Simd::Texel* pTexel) const;
+
+		//function that returns a word of the texel at x, y of a level
+		uint32_t GetTexel(const Level& level, int x, int y, int word = 0) const
+		{
+			return m_Pixels[level.firstWord + (level.offsetX[x] + level.offsetY[y]) * m_TexelWords + word];
+		}
+
+		//function that returns the mip chain of one of the images with every level in row order
+		std::vector<MipLevel> GetMipChain(int word) const;
+
+		static bool CanPack(const SoftwareTexture* pFirst, const SoftwareTexture* pSecond);
+	};
+}
@@ -1,6 +1,6 @@
 #include "pch.h"
 #include "Texture.h"
-#include "Texture.h"
+#include "SoftwareTexture.h"
 #include "Vector2.h"
 #include <SDL_image.h>
 #include <iostream>
@@ -8,13 +8,21 @@
 namespace dae
 {
 	Texture::Texture(SDL_Surface* pSurface, ID3D11Device* pDevice):
-		m_pSurface {pSurface},m_pSurfacePixels{ (uint32_t*)pSurface->pixels }
+		m_pSurface {pSurface}
 	{
+		//Convert to a known texel format, the mip chain is generated once and uploaded to both rasterizers
+		//The software copy is stored in Z-order so rotated views stay cache friendly
+		SDL_Surface* pConverted{ SDL_ConvertSurfaceFormat(pSurface, SDL_PIXELFORMAT_RGBA32, 0) };
+		const std::vector<MipLevel> mipChain{ SoftwareTexture::CreateMipChain(pConverted->w, pConverted->h, static_cast<uint32_t*>(pConverted->pixels)) };
+		SDL_FreeSurface(pConverted);
+
+		m_pSoftwareTexture = new SoftwareTexture{ mipChain, TextureLayout::Morton };
+
 		DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
 		D3D11_TEXTURE2D_DESC desc{};
 		desc.Width = pSurface->w;
 		desc.Height = pSurface->h;
-		desc.MipLevels = 1;
+		desc.MipLevels = static_cast<UINT>(mipChain.size());
 		desc.ArraySize = 1;
 		desc.Format = format;
 		desc.SampleDesc.Count = 1;
@@ -24,18 +32,22 @@ namespace dae
 		desc.CPUAccessFlags = 0;
 		desc.MiscFlags = 0;
 
-		D3D11_SUBRESOURCE_DATA initData;
-		initData.pSysMem = pSurface->pixels;
-		initData.SysMemPitch = static_cast<UINT>(pSurface->pitch);
-		initData.SysMemSlicePitch = static_cast<UINT>(pSurface->h * pSurface->pitch);
+		std::vector<D3D11_SUBRESOURCE_DATA> initData(mipChain.size());
+		for (size_t levelIdx{}; levelIdx < mipChain.size(); ++levelIdx)
+		{
+			const MipLevel& level{ mipChain[levelIdx] };
+			initData[levelIdx].pSysMem = level.pixels.data();
+			initData[levelIdx].SysMemPitch = static_cast<UINT>(level.width * sizeof(uint32_t));
+			initData[levelIdx].SysMemSlicePitch = static_cast<UINT>(level.pixels.size() * sizeof(uint32_t));
+		}
 
-		HRESULT hr = pDevice->CreateTexture2D(&desc, &initData, &m_pResource);
+		HRESULT hr = pDevice->CreateTexture2D(&desc, initData.data(), &m_pResource);
 
 
 		D3D11_SHADER_RESOURCE_VIEW_DESC SRVDesc{};
 		SRVDesc.Format = format;
 		SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-		SRVDesc.Texture2D.MipLevels = 1;
+		SRVDesc.Texture2D.MipLevels = desc.MipLevels;
 
 		hr = pDevice->CreateShaderResourceView(m_pResource, &SRVDesc, &m_pSRV);
 
@@ -47,6 +59,8 @@ namespace dae
 
 	Texture::~Texture()
 	{
+		delete m_pSoftwareTexture;
+
 		if (m_pSRV)m_pSRV->Release();
 		if (m_pResource)m_pResource->Release();
 
@@ -66,28 +80,4 @@ namespace dae
 		return new Texture{ IMG_Load(path.c_str()), pDevice};
 	}
 
-	ColorRGB Texture::Sample(const Vector2& uv) const
-	{
-		//TODO
-		//Sample the correct texel for the given uv
-
-		//calculate the x and y coordinates on the uv map
-		const int x{ static_cast<int>(uv.x * m_pSurface->w) };
-		const int y{ static_cast<int>(uv.y * m_pSurface->h) };
-
-		//getht the index of the pixel in the list
-		const uint32_t pixel{ m_pSurfacePixels[x + y * m_pSurface->w] };
-
-		//initialize the rgb values in the [0, 255] range
-		Uint8 r{};
-		Uint8 g{};
-		Uint8 b{};
-
-		//Get correct values from the texture
-		SDL_GetRGB(pixel, m_pSurface->format, &r, &g, &b);
-
-		//return color divided by 255 to get colors in [0, 1] range
-		return ColorRGB{ r / 255.0f, g / 255.0f, b / 255.0f };
-	}
-
 }
@@ -3,6 +3,8 @@ struct Vector2;
 
 namespace dae
 {
+	class SoftwareTexture;
+
 	class Texture
 	{
 	public:
@@ -12,13 +14,15 @@ namespace dae
 
 		ID3D11ShaderResourceView* GetResource() const { return m_pSRV; };
 
-		ColorRGB Sample(const Vector2& uv) const;
+		const SoftwareTexture* GetSoftwareTexture() const { return m_pSoftwareTexture; };
 
 	private:
 		Texture(SDL_Surface* pSurface, ID3D11Device* pDevice);
 
 		SDL_Surface* m_pSurface{ nullptr };
-		uint32_t* m_pSurfacePixels{ nullptr };
+
+		//CPU side copy of the texels, sampled by the software rasterizer
+		SoftwareTexture* m_pSoftwareTexture{ nullptr };
 
 		ID3D11Texture2D* m_pResource;
 		ID3D11ShaderResourceView* m_pSRV;
@@ -0,0 +1,132 @@
+#include "pch.h"
+#include "ThreadPool.h"
+
+namespace dae
+{
+	ThreadPool::ThreadPool(int numThreads)
+	{
+		if (numThreads <= 0)
+			numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+		m_Workers.reserve(numThreads - 1);
+		for (int i{ 1 }; i < numThreads; ++i)
+		{
+			m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock{ m_Mutex };
+			m_IsStopping = true;
+		}
+		m_WorkAvailable.notify_all();
+
+		for (auto& worker : m_Workers)
+		{
+			worker.join();
+		}
+	}
+
+	void ThreadPool::Run(int count, const void* pJob, void (*pInvokeJob)(const void* pJob, int index))
+	{
+		if (count <= 0)
+			return;
+
+		//Not worth waking the workers
+		if (count == 1 || m_Workers.empty())
+		{
+			for (int i{}; i < count; ++i)
+			{
+				pInvokeJob(pJob, i);
+			}
+			return;
+		}
+
+		{
+			std::lock_guard lock{ m_Mutex };
+			m_pJob = pJob;
+			m_pInvokeJob = pInvokeJob;
+			m_JobCount = count;
+			m_NextJob = 0;
+			m_BusyWorkers = static_cast<int>(m_Workers.size());
+			++m_Generation;
+		}
+		m_WorkAvailable.notify_all();
+
+		RunJobs();
+
+		//Wait until every worker has left the job, the job is owned by the caller
+		std::unique_lock lock{ m_Mutex };
+		m_WorkDone.wait(lock, [this] { return m_BusyWorkers == 0; });
+		m_pJob = nullptr;
+		m_pInvokeJob = nullptr;
+	}
+
+	void ThreadPool::Enqueue(std::function<void()> task)
+	{
+		if (m_Workers.empty())
+		{
+			task();
+			return;
+		}
+
+		{
+			std::lock_guard lock{ m_Mutex };
+			m_Tasks.push_back(std::move(task));
+		}
+		m_WorkAvailable.notify_one();
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		uint64_t lastGeneration{};
+
+		while (true)
+		{
+			std::function<void()> task{};
+			{
+				std::unique_lock lock{ m_Mutex };
+				m_WorkAvailable.wait(lock, [this, lastGeneration] { return m_IsStopping || m_Generation != lastGeneration || !m_Tasks.empty(); });
+
+				//A ParallelFor waits for every worker, so it goes before the queued tasks
+				if (m_Generation != lastGeneration)
+				{
+					lastGeneration = m_Generation;
+				}
+				else if (!m_Tasks.empty())
+				{
+					task = std::move(m_Tasks.front());
+					m_Tasks.pop_front();
+				}
+				else
+				{
+					return;
+				}
+			}
+
+			if (task)
+			{
+				task();
+				continue;
+			}
+
+			RunJobs();
+
+			{
+				std::lock_guard lock{ m_Mutex };
+				--m_BusyWorkers;
+			}
+			m_WorkDone.notify_one();
+		}
+	}
+
+	void ThreadPool::RunJobs()
+	{
+		for (int index{ m_NextJob++ }; index < m_JobCount; index = m_NextJob++)
+		{
+			m_pInvokeJob(m_pJob, index);
+		}
+	}
+}
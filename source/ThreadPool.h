@@ -0,0 +1,74 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <deque>
+
+namespace dae
+{
+	//Persistent pool of worker threads, the calling thread always takes part in the work of ParallelFor
+	//Submitted tasks only run on the workers, a worker picks up a ParallelFor before any queued task
+	class ThreadPool final
+	{
+	public:
+		//numThreads includes the calling thread, 0 uses every hardware thread
+		explicit ThreadPool(int numThreads = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) noexcept = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+
+		//Calls job(index) for every index in [0, count) spread over all threads, returns when every job is done
+		//The job is only borrowed for the duration of the call so it is never copied or allocated
+		template<typename Job>
+		void ParallelFor(int count, const Job& job)
+		{
+			Run(count, &job, [](const void* pJob, int index) { (*static_cast<const Job*>(pJob))(index); });
+		}
+
+		//Queues task() to run on a worker and returns a future of its result, a pool without workers runs it right away
+		//A task must not call ParallelFor on the pool it runs on, that waits for the worker running the task
+		template<typename Task>
+		auto Submit(Task&& task) -> std::future<std::invoke_result_t<std::decay_t<Task>>>
+		{
+			using Result = std::invoke_result_t<std::decay_t<Task>>;
+
+			//std::function needs a copyable target, the task itself only has to be movable
+			auto pTask{ std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task)) };
+			std::future<Result> future{ pTask->get_future() };
+
+			Enqueue([pTask]() { (*pTask)(); });
+			return future;
+		}
+
+		int GetNumThreads() const { return static_cast<int>(m_Workers.size()) + 1; }
+
+	private:
+		std::vector<std::thread> m_Workers{};
+
+		std::mutex m_Mutex{};
+		std::condition_variable m_WorkAvailable{};
+		std::condition_variable m_WorkDone{};
+
+		const void* m_pJob{};
+		void (*m_pInvokeJob)(const void* pJob, int index) {};
+		int m_JobCount{};
+		std::atomic<int> m_NextJob{};
+		int m_BusyWorkers{};
+		uint64_t m_Generation{};
+		bool m_IsStopping{ false };
+
+		//Submitted tasks that no worker picked up yet, the workers finish them before the pool stops
+		std::deque<std::function<void()>> m_Tasks{};
+
+		void Run(int count, const void* pJob, void (*pInvokeJob)(const void* pJob, int index));
+		void Enqueue(std::function<void()> task);
+		void WorkerLoop();
+		void RunJobs();
+	};
+}
@@ -0,0 +1,380 @@
+#include "pch.h"
+#include "Utils.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+#include <charconv>
+#include <cstring>
+#include <unordered_map>
+
+namespace dae
+{
+	namespace Utils
+	{
+		namespace
+		{
+			//Files are only split when every thread gets at least this many bytes
+			constexpr size_t g_MinChunkSize{ 256 * 1024 };
+
+			//Position, texcoord and normal index of a face corner as written in the file, 0 when the corner doesn't have one
+			struct ObjVertexKey
+			{
+				uint32_t position{};
+				uint32_t uv{};
+				uint32_t normal{};
+
+				bool operator==(const ObjVertexKey& rhs) const = default;
+			};
+
+			struct ObjVertexKeyHash
+			{
+				size_t operator()(const ObjVertexKey& key) const
+				{
+					size_t hash{ key.position };
+					hash = hash * 0x9E3779B1 ^ key.uv;
+					hash = hash * 0x9E3779B1 ^ key.normal;
+					return hash;
+				}
+			};
+
+			//Everything read from one chunk of the file, face corners keep their file indices so chunks are stitched by appending
+			struct ObjChunk
+			{
+				std::vector<Vector3> positions{};
+				std::vector<Vector3> normals{};
+				std::vector<Vector2> UVs{};
+
+				//Three corners per triangle, in file winding
+				std::vector<ObjVertexKey> corners{};
+
+				bool isValid{ true };
+			};
+
+			bool IsSpace(char c)
+			{
+				return c == ' ' || c == '\t' || c == '\r';
+			}
+
+			void SkipSpaces(const char*& pCurrent, const char* pEnd)
+			{
+				while (pCurrent < pEnd && IsSpace(*pCurrent))
+					++pCurrent;
+			}
+
+			bool ParseFloat(const char*& pCurrent, const char* pEnd, float& value)
+			{
+				SkipSpaces(pCurrent, pEnd);
+
+				//from_chars doesn't accept an explicit plus sign
+				if (pCurrent < pEnd && *pCurrent == '+')
+					++pCurrent;
+
+				const auto [pNext, error] { std::from_chars(pCurrent, pEnd, value) };
+				if (error != std::errc{})
+					return false;
+
+				pCurrent = pNext;
+				return true;
+			}
+
+			bool ParseIndex(const char*& pCurrent, const char* pEnd, uint32_t& value)
+			{
+				//Relative (negative) indices aren't supported
+				if (pCurrent >= pEnd || *pCurrent < '0' || *pCurrent > '9')
+					return false;
+
+				value = 0;
+				while (pCurrent < pEnd && *pCurrent >= '0' && *pCurrent <= '9')
+				{
+					value = value * 10 + static_cast<uint32_t>(*pCurrent - '0');
+					++pCurrent;
+				}
+
+				return true;
+			}
+
+			//Reads one "position/uv/normal" corner, the uv and normal are optional
+			bool ParseCorner(const char*& pCurrent, const char* pEnd, ObjVertexKey& key)
+			{
+				if (!ParseIndex(pCurrent, pEnd, key.position))
+					return false;
+
+				if (pCurrent < pEnd && *pCurrent == '/')
+				{
+					++pCurrent;
+
+					if (pCurrent < pEnd && *pCurrent != '/' && !ParseIndex(pCurrent, pEnd, key.uv))
+						return false;
+
+					if (pCurrent < pEnd && *pCurrent == '/')
+					{
+						++pCurrent;
+
+						if (!ParseIndex(pCurrent, pEnd, key.normal))
+							return false;
+					}
+				}
+
+				return true;
+			}
+
+			void ParseChunk(const char* pBegin, const char* pEnd, ObjChunk& chunk)
+			{
+				const char* pCurrent{ pBegin };
+
+				while (pCurrent < pEnd)
+				{
+					const char* pLineEnd{ static_cast<const char*>(std::memchr(pCurrent, '\n', pEnd - pCurrent)) };
+					if (!pLineEnd)
+						pLineEnd = pEnd;
+
+					SkipSpaces(pCurrent, pLineEnd);
+
+					const size_t lineLength{ static_cast<size_t>(pLineEnd - pCurrent) };
+					const char command0{ lineLength > 0 ? pCurrent[0] : '\0' };
+					const bool isSeparated{ lineLength > 1 && IsSpace(pCurrent[1]) };
+					const bool isSeparated2{ lineLength > 2 && IsSpace(pCurrent[2]) };
+
+					bool isValid{ true };
+
+					if (command0 == 'v' && isSeparated)
+					{
+						//Vertex
+						pCurrent += 1;
+						Vector3 position{};
+						isValid = ParseFloat(pCurrent, pLineEnd, position.x) && ParseFloat(pCurrent, pLineEnd, position.y) && ParseFloat(pCurrent, pLineEnd, position.z);
+						chunk.positions.push_back(position);
+					}
+					else if (command0 == 'v' && isSeparated2 && pCurrent[1] == 't')
+					{
+						// Vertex TexCoord
+						pCurrent += 2;
+						Vector2 uv{};
+						isValid = ParseFloat(pCurrent, pLineEnd, uv.x) && ParseFloat(pCurrent, pLineEnd, uv.y);
+						chunk.UVs.emplace_back(uv.x, 1 - uv.y);
+					}
+					else if (command0 == 'v' && isSeparated2 && pCurrent[1] == 'n')
+					{
+						// Vertex Normal
+						pCurrent += 2;
+						Vector3 normal{};
+						isValid = ParseFloat(pCurrent, pLineEnd, normal.x) && ParseFloat(pCurrent, pLineEnd, normal.y) && ParseFloat(pCurrent, pLineEnd, normal.z);
+						chunk.normals.push_back(normal);
+					}
+					else if (command0 == 'f' && isSeparated)
+					{
+						//Faces with more than 3 corners are split into a fan
+						pCurrent += 1;
+						ObjVertexKey firstCorner{};
+						ObjVertexKey previousCorner{};
+						int numCorners{};
+
+						SkipSpaces(pCurrent, pLineEnd);
+						while (isValid && pCurrent < pLineEnd)
+						{
+							ObjVertexKey corner{};
+							isValid = ParseCorner(pCurrent, pLineEnd, corner);
+
+							if (numCorners >= 2)
+							{
+								chunk.corners.push_back(firstCorner);
+								chunk.corners.push_back(previousCorner);
+								chunk.corners.push_back(corner);
+							}
+
+							if (numCorners == 0)
+								firstCorner = corner;
+
+							previousCorner = corner;
+							++numCorners;
+
+							SkipSpaces(pCurrent, pLineEnd);
+						}
+
+						isValid = isValid && numCorners >= 3;
+					}
+
+					if (!isValid)
+					{
+						chunk.isValid = false;
+						return;
+					}
+
+					//Comments and every other command are ignored
+					pCurrent = pLineEnd + 1;
+				}
+			}
+		}
+
+		bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding, int numThreads)
+		{
+			const MappedFile file{ filename };
+			if (!file.IsValid())
+				return false;
+
+			vertices.clear();
+			indices.clear();
+
+			const char* pData{ file.GetData() };
+			const size_t size{ file.GetSize() };
+
+			if (numThreads <= 0)
+				numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+			const int numChunks{ static_cast<int>(std::clamp(size / g_MinChunkSize, size_t{ 1 }, static_cast<size_t>(numThreads))) };
+
+			//Every chunk starts right after the line break following its even split point, so no line is split
+			std::vector<const char*> chunkStarts(numChunks + 1);
+			chunkStarts[0] = pData;
+			chunkStarts[numChunks] = pData + size;
+			for (int chunkIdx{ 1 }; chunkIdx < numChunks; ++chunkIdx)
+			{
+				const char* pSplit{ std::max(pData + size / numChunks * chunkIdx, chunkStarts[chunkIdx - 1]) };
+				const char* pLineEnd{ static_cast<const char*>(std::memchr(pSplit, '\n', pData + size - pSplit)) };
+				chunkStarts[chunkIdx] = pLineEnd ? pLineEnd + 1 : pData + size;
+			}
+
+			std::vector<ObjChunk> chunks(numChunks);
+
+			if (numChunks == 1)
+			{
+				ParseChunk(chunkStarts[0], chunkStarts[1], chunks[0]);
+			}
+			else
+			{
+				ThreadPool threadPool{ numChunks };
+				threadPool.ParallelFor(numChunks, [&chunks, &chunkStarts](int chunkIdx)
+					{
+						ParseChunk(chunkStarts[chunkIdx], chunkStarts[chunkIdx + 1], chunks[chunkIdx]);
+					});
+			}
+
+			//Stitch the chunks together, face indices are already global
+			size_t numPositions{};
+			size_t numNormals{};
+			size_t numUVs{};
+			size_t numCorners{};
+			for (const ObjChunk& chunk : chunks)
+			{
+				if (!chunk.isValid)
+					return false;
+
+				numPositions += chunk.positions.size();
+				numNormals += chunk.normals.size();
+				numUVs += chunk.UVs.size();
+				numCorners += chunk.corners.size();
+			}
+
+			std::vector<Vector3> positions{};
+			std::vector<Vector3> normals{};
+			std::vector<Vector2> UVs{};
+			positions.reserve(numPositions);
+			normals.reserve(numNormals);
+			UVs.reserve(numUVs);
+
+			for (const ObjChunk& chunk : chunks)
+			{
+				positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+				normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+				UVs.insert(UVs.end(), chunk.UVs.begin(), chunk.UVs.end());
+			}
+
+			//Corners with the same position, texcoord and normal share a single vertex
+			std::unordered_map<ObjVertexKey, uint32_t, ObjVertexKeyHash> vertexLookup{};
+			vertexLookup.reserve(numCorners / 2);
+			indices.reserve(numCorners);
+
+			for (const ObjChunk& chunk : chunks)
+			{
+				for (size_t cornerIdx{}; cornerIdx < chunk.corners.size(); cornerIdx += 3)
+				{
+					uint32_t tempIndices[3];
+					for (size_t iFace = 0; iFace < 3; iFace++)
+					{
+						const ObjVertexKey& key{ chunk.corners[cornerIdx + iFace] };
+
+						// OBJ format uses 1-based arrays
+						if (key.position == 0 || key.position > positions.size() || key.uv > UVs.size() || key.normal > normals.size())
+							return false;
+
+						//Only the first corner with this combination creates a vertex
+						auto [it, isNew] { vertexLookup.try_emplace(key, static_cast<uint32_t>(vertices.size())) };
+
+						if (isNew)
+						{
+							Vertex vertex{};
+							vertex.position = positions[key.position - 1];
+							if (key.uv != 0) vertex.uv = UVs[key.uv - 1];
+							if (key.normal != 0) vertex.normal = normals[key.normal - 1];
+
+							vertices.push_back(vertex);
+						}
+
+						tempIndices[iFace] = it->second;
+					}
+
+					//Every face is emitted once, flipping the axis mirrors the mesh so the winding is swapped to stay clockwise
+					indices.push_back(tempIndices[0]);
+					if (flipAxisAndWinding)
+					{
+						indices.push_back(tempIndices[2]);
+						indices.push_back(tempIndices[1]);
+					}
+					else
+					{
+						indices.push_back(tempIndices[1]);
+						indices.push_back(tempIndices[2]);
+					}
+				}
+			}
+
+			//Cheap Tangent Calculations
+			for (uint32_t i = 0; i < indices.size(); i += 3)
+			{
+				uint32_t index0 = indices[i];
+				uint32_t index1 = indices[size_t(i) + 1];
+				uint32_t index2 = indices[size_t(i) + 2];
+
+				const Vector3& p0 = vertices[index0].position;
+				const Vector3& p1 = vertices[index1].position;
+				const Vector3& p2 = vertices[index2].position;
+				const Vector2& uv0 = vertices[index0].uv;
+				const Vector2& uv1 = vertices[index1].uv;
+				const Vector2& uv2 = vertices[index2].uv;
+
+				const Vector3 edge0 = p1 - p0;
+				const Vector3 edge1 = p2 - p0;
+				const Vector2 diffX = Vector2(uv1.x - uv0.x, uv2.x - uv0.x);
+				const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
+
+				//Faces without a uv area have no tangent, vertices are shared so they would spoil their neighbours
+				const float uvArea = Vector2::Cross(diffX, diffY);
+				if (uvArea == 0.f)
+					continue;
+
+				float r = 1.f / uvArea;
+
+				Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
+				vertices[index0].tangent += tangent;
+				vertices[index1].tangent += tangent;
+				vertices[index2].tangent += tangent;
+			}
+
+			//Create the Tangents (reject)
+			for (auto& v : vertices)
+			{
+				v.tangent = Vector3::Reject(v.tangent, v.normal).Normalized();
+
+				if (flipAxisAndWinding)
+				{
+					v.position.z *= -1.f;
+					v.normal.z *= -1.f;
+					v.tangent.z *= -1.f;
+				}
+
+			}
+
+			return true;
+		}
+	}
+}
@@ -86,12 +86,18 @@ int main(int argc, char* args[])
 				case SDL_SCANCODE_F8:
 					pRenderer->ToggleBoundingBox();
 					break;
+				case SDL_SCANCODE_F9:
+					pRenderer->CycleCullMode();
+					break;
 				case SDL_SCANCODE_F10:
 					pRenderer->ToggleClearColor();
 					break;
 				case SDL_SCANCODE_F11:
 					TogglePrintFPS(PrintFPS);
 					break;
+				case SDL_SCANCODE_F12:
+					pRenderer->ToggleVisibilityBuffer();
+					break;
 				default:
 					break;
 				}
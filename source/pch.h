@@ -2,9 +2,20 @@
 
 #include <iostream>
 #include <vector>
+#include <array>
+#include <span>
+#include <bit>
 #include <algorithm>
 #include <sstream>
 #include <memory>
+#include <string>
+#include <cstdint>
+#include <cfloat>
+#include <climits>
+
+// The software rasterizer library and the headless target define SOFTWARE_RASTERIZER_ONLY,
+// they only need the standard library and the math/framework headers below
+#if !defined(SOFTWARE_RASTERIZER_ONLY)
 #define NOMINMAX  //for directx
 
 // SDL Headers
@@ -18,6 +29,7 @@
 #include <d3d11.h>
 #include <d3dcompiler.h>
 #include <d3dx11effect.h>
+#endif
 
 // Framework Headers
 #include "Timer.h"
@@ -55,4 +67,11 @@ enum class ShadingMode
 	Diffuse,
 	Specular,
 	Combined
+};
+
+enum class CullMode
+{
+	Back,
+	Front,
+	None
 };
\ No newline at end of file